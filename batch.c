@@ -0,0 +1,256 @@
+/*
+ * batch.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides batches: many ops applied under one round of
+ * stripe locks, with one RPC to each other partition
+ */
+
+#include "headers.h"
+
+extern int CHAIN_NUM;
+
+/*
+	Batches
+
+	apply_batch makes three passes over its ops. The first finds what
+	the other partitions have to do for them, as (op, a, b) triples,
+	without taking a lock: a vertex of this partition, once there,
+	never goes away, so whether it exists by a given op only depends
+	on the store and the add_node ops before it. The second sends each
+	partition its triples in one apply_ops RPC, which runs them in
+	order under one round of its own stripe locks. The third takes the
+	stripes of every vertex the batch writes, once, and applies the
+	ops in order with the codes that came back. An edge across two
+	partitions is thus written over there first, as add_edge does.
+	No lock is held across an RPC, so two partitions sending each
+	other batches can't wait on each other: the filter drops a new
+	vertex may need are sent by the filter thread, and waited for in
+	filter_sync only once the stripes are unlocked.
+*/
+
+// Marks an op with nothing to do on another partition
+#define NO_REMOTE (~0U)
+
+// An add_node op of a batch
+typedef struct batch_add {
+	uint64_t id;
+	size_t i;		// its place in the batch
+} batch_add;
+
+// Triples for one partition and the codes it sent back
+typedef struct batch_remote {
+	uint64_t *ops;
+	size_t n;		// triples
+	size_t cap;
+	uint64_t *codes;
+} batch_remote;
+
+static inline int owner(uint64_t id) {
+	return id % PARTITIONS + 1;
+}
+
+static inline bool is_local(uint64_t id) {
+	return owner(id) == CHAIN_NUM;
+}
+
+static int cmp_add(const void *x, const void *y) {
+	const batch_add *a = x, *b = y;
+	if (a->id != b->id) return a->id < b->id ? -1 : 1;
+	return a->i < b->i ? -1 : a->i > b->i;
+}
+
+// Returns whether vertex id of this partition exists once the ops
+// before op i have run; adds holds the batch's add_node ops, sorted
+static bool exists_by(const batch_add *adds, size_t nadds, uint64_t id, size_t i) {
+	size_t lo = 0, hi = nadds;
+
+	if (get_node(id)) return true;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (adds[mid].id < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo < nadds && adds[lo].id == id && adds[lo].i < i;
+}
+
+// Queues triple (op, a, b) for a partition; returns its place there
+static uint32_t ask(batch_remote *r, uint64_t op, uint64_t a, uint64_t b) {
+	if (r->n == r->cap) {
+		r->cap = r->cap ? r->cap * 2 : 64;
+		r->ops = realloc(r->ops, 3 * r->cap * sizeof(uint64_t));
+		if (!r->ops) exit(1);
+	}
+	r->ops[3 * r->n] = op;
+	r->ops[3 * r->n + 1] = a;
+	r->ops[3 * r->n + 2] = b;
+	return r->n++;
+}
+
+// Returns the code the owner of id sent back for the triple at place at
+static inline int answer(const batch_remote *remote, uint64_t id, uint32_t at) {
+	return remote[owner(id)].codes[at];
+}
+
+// Applies op o here, given what the other partitions answered; returns
+// its code. Stripes are locked already.
+static int apply_local(batch_op *o, const batch_remote *remote) {
+	bool la = is_local(o->a), lb = is_local(o->b);
+	int code;
+
+	switch (o->op) {
+		case ADD_NODE:
+			if (!la) return 400;
+			return add_vertex(o->a) ? 200 : 204;
+		case ADD_EDGE:
+			if (!la && !lb) return 400;
+			if ((la && !get_node(o->a)) || (lb && !get_node(o->b))) return 400;
+			if (la && lb) return add_edge(o->a, o->b);
+			// the other partition wasn't asked if our endpoint was missing
+			if (o->at[0] == NO_REMOTE) return 400;
+			code = answer(remote, la ? o->b : o->a, o->at[0]);
+			return code == 200 ? add_cross_edge(o->a, o->b) : code;
+		case REMOVE_EDGE:
+			if (!la && !lb) return 400;
+			if (!(la && lb) && (code = answer(remote, la ? o->b : o->a, o->at[0])) != 200) {
+				return code;
+			}
+			return remove_edge(o->a, o->b) ? 200 : 400;
+		case GET_NODE:
+			if (!la) return 400;
+			return get_node(o->a) ? 200 : 204;
+		case GET_EDGE:
+			if ((la && !get_node(o->a)) || (lb && !get_node(o->b))) return 400;
+			if (!la && o->at[0] != NO_REMOTE) {
+				if ((code = answer(remote, o->a, o->at[0])) != 200) return code;
+				rcache_add(o->a);
+			}
+			if (!lb && o->at[1] != NO_REMOTE) {
+				if ((code = answer(remote, o->b, o->at[1])) != 200) return code;
+				rcache_add(o->b);
+			}
+			return get_edge(o->a, o->b) ? 200 : 204;
+		case GET_NEIGHBORS:
+			if (!get_node(o->a)) return 400;
+			o->neighbors = get_neighbors(o->a, &o->n);
+			return 200;
+	}
+	return 400;
+}
+
+// Applies the n ops in order, setting their codes; the stripes they
+// write are locked once, and the other partitions get one RPC each
+void apply_batch(batch_op *ops, size_t n) {
+	batch_remote remote[PARTITIONS + 1] = { { 0 } };
+	batch_add *adds = malloc(n * sizeof(batch_add));
+	uint64_t *ids = malloc(2 * n * sizeof(uint64_t));
+	uint64_t taken;
+	size_t nadds = 0, nids = 0, i, k;
+	int p;
+
+	if (!adds || !ids) exit(1);
+	for (i = 0; i < n; i++) {
+		if (ops[i].op == ADD_NODE && is_local(ops[i].a)) {
+			adds[nadds].id = ops[i].a;
+			adds[nadds++].i = i;
+		}
+	}
+	qsort(adds, nadds, sizeof(batch_add), cmp_add);
+
+	// what the other partitions have to do
+	for (i = 0; i < n; i++) {
+		batch_op *o = &ops[i];
+		bool la = is_local(o->a), lb = is_local(o->b);
+
+		o->at[0] = o->at[1] = NO_REMOTE;
+		switch (o->op) {
+			case ADD_EDGE:
+				// only if the endpoint here will be there
+				if (la != lb && exists_by(adds, nadds, la ? o->a : o->b, i)) {
+					o->at[0] = ask(&remote[owner(la ? o->b : o->a)], ADD_EDGE, o->a, o->b);
+				}
+				break;
+			case REMOVE_EDGE:
+				if (la != lb) o->at[0] = ask(&remote[owner(la ? o->b : o->a)], REMOVE_EDGE, o->a, o->b);
+				break;
+			case GET_EDGE:
+				// not if they confirmed it before
+				if (!la && !rcache_has(o->a)) o->at[0] = ask(&remote[owner(o->a)], GET_NODE, o->a, 0);
+				if (!lb && !rcache_has(o->b)) o->at[1] = ask(&remote[owner(o->b)], GET_NODE, o->b, 0);
+				break;
+		}
+	}
+	free(adds);
+
+	// one RPC per partition
+	for (p = 1; p <= PARTITIONS; p++) {
+		if (!remote[p].n) continue;
+		remote[p].codes = malloc(remote[p].n * sizeof(uint64_t));
+		if (!remote[p].codes) exit(1);
+		if (!send_ops(p, remote[p].ops, remote[p].n, remote[p].codes)) {
+			for (k = 0; k < remote[p].n; k++) remote[p].codes[k] = 500;
+		}
+	}
+
+	// the writes here, under one round of locks
+	for (i = 0; i < n; i++) {
+		if (ops[i].op == ADD_NODE) {
+			ids[nids++] = ops[i].a;
+		} else if (ops[i].op == ADD_EDGE || ops[i].op == REMOVE_EDGE) {
+			ids[nids++] = ops[i].a;
+			ids[nids++] = ops[i].b;
+		}
+	}
+	taken = lock_stripes(ids, nids);
+	for (i = 0; i < n; i++) ops[i].code = apply_local(&ops[i], remote);
+	unlock_stripes(taken);
+	free(ids);
+	// with the locks let go, so the filter thread can't hold them up
+	filter_sync();
+
+	for (p = 1; p <= PARTITIONS; p++) {
+		free(remote[p].ops);
+		free(remote[p].codes);
+	}
+}
+
+// Applies a triple sent by another partition; returns its code.
+// Stripes are locked already.
+static int apply_remote(uint64_t op, uint64_t a, uint64_t b) {
+	switch (op) {
+		case ADD_NODE:
+			return add_vertex(a) ? 200 : 204;
+		case ADD_EDGE:
+			// our endpoint has to exist; the sender's is kept as a
+			// ghost only if the edge is added
+			if (!get_node(is_local(a) ? a : b)) return 400;
+			return add_cross_edge(a, b);
+		case REMOVE_EDGE:
+			return remove_edge(a, b) ? 200 : 400;
+		case GET_NODE:
+			return get_node(a) ? 200 : 400;
+	}
+	return 400;
+}
+
+// Applies n (op, a, b) triples sent by another partition's batch, in
+// order, writing a code for each
+void apply_ops(const uint64_t *ops, size_t n, uint64_t *codes) {
+	uint64_t *ids = calloc(2 * n + 1, sizeof(uint64_t));
+	uint64_t taken;
+	size_t nids = 0, i;
+
+	if (!ids) exit(1);
+	for (i = 0; i < n; i++) {
+		if (ops[3 * i] == GET_NODE) continue;
+		ids[nids++] = ops[3 * i + 1];
+		if (ops[3 * i] != ADD_NODE) ids[nids++] = ops[3 * i + 2];
+	}
+	taken = lock_stripes(ids, nids);
+	for (i = 0; i < n; i++) codes[i] = apply_remote(ops[3 * i], ops[3 * i + 1], ops[3 * i + 2]);
+	unlock_stripes(taken);
+	free(ids);
+	filter_sync();
+}
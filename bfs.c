@@ -0,0 +1,499 @@
+/*
+ * bfs.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides breadth-first searches: shortest paths and k-hop
+ * neighborhoods across partitions, by shipping each level's frontier
+ * to the partitions owning it, and a direction-optimizing BFS over
+ * the partition's CSR snapshot
+ */
+
+#include "headers.h"
+
+extern int CHAIN_NUM;
+
+/*
+	Distributed shortest path
+
+	The partition that owns a vertex holds its whole neighbor list,
+	since an edge to another partition is stored on both sides. So the
+	partition answering the query runs a bidirectional BFS and expands
+	a level by splitting the frontier by owner: its own part is
+	expanded here, every other part in one expand_frontier RPC to the
+	owner. The two searches advance a whole level at a time on the
+	side with the smaller frontier, and the first level on which they
+	meet holds the shortest path. What has been reached is kept in a
+	table local to the query, so searches can run side by side.
+*/
+
+// A vertex reached by the search
+typedef struct path_slot {
+	uint64_t id;
+	uint32_t dist;		// from the side that reached it
+	uint32_t side;		// 0 for a free slot, else side + 1
+} path_slot;
+
+// Open addressing table of the vertices reached, by id
+typedef struct path_table {
+	path_slot *slots;
+	size_t mask;		// capacity - 1, a power of two minus one
+	size_t size;
+} path_table;
+
+// Growable array of vertex ids
+typedef struct id_vec {
+	uint64_t *ids;
+	size_t n;
+	size_t cap;
+} id_vec;
+
+// Cumulative counters reported by path_stats
+static uint64_t path_queries;
+static uint64_t path_levels;
+static uint64_t path_bytes;
+
+static void vec_push(id_vec *v, uint64_t id) {
+	if (v->n == v->cap) {
+		v->cap = v->cap ? v->cap * 2 : 256;
+		v->ids = realloc(v->ids, v->cap * sizeof(uint64_t));
+		if (!v->ids) exit(1);
+	}
+	v->ids[v->n++] = id;
+}
+
+// Returns id's slot, or the free slot it would go in
+static path_slot *table_find(path_table *t, uint64_t id) {
+	size_t i = hash_vertex(id) & t->mask;
+
+	while (t->slots[i].side && t->slots[i].id != id) i = (i + 1) & t->mask;
+	return &t->slots[i];
+}
+
+// Records id as reached by side at dist; id must not be in t yet
+static void table_add(path_table *t, uint64_t id, int side, uint32_t dist) {
+	path_slot *s;
+
+	// keep the load under one half
+	if (++t->size * 2 > t->mask + 1) {
+		path_slot *old = t->slots;
+		size_t i, cap = t->mask + 1;
+
+		t->slots = calloc(cap * 2, sizeof(path_slot));
+		if (!t->slots) exit(1);
+		t->mask = cap * 2 - 1;
+		for (i = 0; i < cap; i++)
+			if (old[i].side) *table_find(t, old[i].id) = old[i];
+		free(old);
+	}
+	s = table_find(t, id);
+	s->id = id;
+	s->dist = dist;
+	s->side = side + 1;
+}
+
+// Returns the neighbors of the vertices in part, all owned by partition
+// p, or NULL with *n set to -1 if p can't be reached
+static uint64_t *expand_part(int p, const id_vec *part, size_t *n, uint64_t *bytes) {
+	uint64_t *out = NULL;
+
+	if (p == CHAIN_NUM) return frontier_neighbors(part->ids, part->n, n);
+	if (!send_frontier(p, part->ids, part->n, &out, n, bytes)) {
+		*n = (size_t) -1;
+		return NULL;
+	}
+	return out;
+}
+
+// Returns the neighbors of the vertices in front, each part asked of
+// its owner, or NULL with *n set to -1 if a partition can't be reached.
+// A vertex may come back once per partition.
+static uint64_t *expand_front(const id_vec *front, size_t *n, uint64_t *bytes) {
+	id_vec parts[PARTITIONS] = {{0}}, all = {0};
+	int p;
+	size_t i;
+
+	for (i = 0; i < front->n; i++) vec_push(&parts[front->ids[i] % PARTITIONS], front->ids[i]);
+	*n = 0;
+	for (p = 0; p < PARTITIONS; p++) {
+		uint64_t *out;
+		size_t k;
+
+		if (!parts[p].n) continue;
+		out = expand_part(p + 1, &parts[p], &k, bytes);
+		if (k == (size_t) -1) {
+			free(all.ids);
+			all.ids = NULL;
+			*n = (size_t) -1;
+			break;
+		}
+		if (!all.ids) {
+			// the first part is taken as is
+			all.ids = out;
+			all.n = all.cap = k;
+			continue;
+		}
+		for (i = 0; i < k; i++) vec_push(&all, out[i]);
+		free(out);
+	}
+	for (p = 0; p < PARTITIONS; p++) free(parts[p].ids);
+	if (*n != (size_t) -1) *n = all.n;
+	return all.ids;
+}
+
+// Expands one level of side's frontier into next; returns the shortest
+// path through an edge to a vertex the other side reached, -1 if there
+// is none, or -2 if a partition can't be reached
+static int expand_level(path_table *t, id_vec *front, id_vec *next, int side,
+	uint32_t depth, uint64_t *bytes) {
+	int best = -1;
+	size_t i, n;
+	uint64_t *out = expand_front(front, &n, bytes);
+
+	next->n = 0;
+	if (n == (size_t) -1) return -2;
+	for (i = 0; i < n; i++) {
+		path_slot *s = table_find(t, out[i]);
+		if (!s->side) {
+			table_add(t, out[i], side, depth + 1);
+			vec_push(next, out[i]);
+		} else if (s->side != side + 1) {
+			int d = depth + 1 + s->dist;
+			if (best < 0 || d < best) best = d;
+		}
+	}
+	free(out);
+	return best;
+}
+
+// Returns the length of the shortest path between two vertices over all
+// partitions, -1 if they aren't connected, or -2 if a partition couldn't
+// be reached; *levels and *bytes get the BFS levels expanded and the
+// frontier bytes shipped to other partitions
+int distributed_path(uint64_t id1, uint64_t id2, uint32_t *levels, uint64_t *bytes) {
+	path_table t;
+	id_vec front[2] = {{0}}, next = {0};
+	uint32_t depth[2] = {0, 0};
+	int d = -1;
+
+	*levels = 0;
+	*bytes = 0;
+	if (id1 == id2) return 0;
+
+	t.mask = 1023;
+	t.size = 0;
+	t.slots = calloc(t.mask + 1, sizeof(path_slot));
+	if (!t.slots) exit(1);
+	table_add(&t, id1, 0, 0);
+	vec_push(&front[0], id1);
+	table_add(&t, id2, 1, 0);
+	vec_push(&front[1], id2);
+
+	while (d == -1 && front[0].n && front[1].n) {
+		int side = front[0].n > front[1].n;
+		id_vec tmp;
+
+		d = expand_level(&t, &front[side], &next, side, depth[side], bytes);
+		depth[side]++;
+		(*levels)++;
+		tmp = front[side];
+		front[side] = next;
+		next = tmp;
+	}
+
+	free(t.slots);
+	free(front[0].ids);
+	free(front[1].ids);
+	free(next.ids);
+	__atomic_add_fetch(&path_queries, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&path_levels, *levels, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&path_bytes, *bytes, __ATOMIC_RELAXED);
+	return d;
+}
+
+// Returns the number of distributed searches run, and their total
+// levels and bytes shipped
+uint64_t path_stats(uint64_t *levels, uint64_t *bytes) {
+	*levels = __atomic_load_n(&path_levels, __ATOMIC_RELAXED);
+	*bytes = __atomic_load_n(&path_bytes, __ATOMIC_RELAXED);
+	return __atomic_load_n(&path_queries, __ATOMIC_RELAXED);
+}
+
+/*
+	k-hop neighborhoods
+
+	A k-hop query runs the same level-at-a-time expansion from one
+	side only, for k levels, with every vertex kept once in the query's
+	table: a level's frontier is split by owner, so a stub here stands
+	for a vertex whose whole list is asked of its partition, in the one
+	expand_frontier RPC that partition gets per level. A vertex reached
+	again, from the same level or an earlier one, is not expanded
+	again. The last level is only counted. Once limit vertices have
+	been reached the query stops, and says it was cut short.
+*/
+
+static int cmp_u64(const void *x, const void *y) {
+	uint64_t a = *(const uint64_t *) x, b = *(const uint64_t *) y;
+	return a < b ? -1 : a > b;
+}
+
+// Fills r with the vertices within k hops of id over all partitions, id
+// itself left out, stopping once limit have been reached; with ids set,
+// r->ids gets them sorted, to be freed by the caller. Returns 0, or -2
+// if a partition couldn't be reached.
+int distributed_khop(uint64_t id, uint32_t k, uint64_t limit, bool ids, khop_result *r) {
+	path_table t;
+	id_vec front = {0}, next = {0}, tmp;
+	int err = 0;
+	size_t i;
+
+	memset(r, 0, sizeof(khop_result));
+	t.mask = 1023;
+	t.size = 0;
+	t.slots = calloc(t.mask + 1, sizeof(path_slot));
+	if (!t.slots) exit(1);
+	table_add(&t, id, 0, 0);
+	vec_push(&front, id);
+
+	while (r->levels < k && front.n && !r->truncated) {
+		uint64_t *out;
+		size_t n;
+
+		out = expand_front(&front, &n, &r->bytes);
+		if (n == (size_t) -1) {
+			err = -2;
+			break;
+		}
+		next.n = 0;
+		for (i = 0; i < n; i++) {
+			if (table_find(&t, out[i])->side) continue;
+			if (r->count == limit) {
+				r->truncated = true;
+				break;
+			}
+			table_add(&t, out[i], 0, r->levels + 1);
+			vec_push(&next, out[i]);
+			r->count++;
+		}
+		free(out);
+		r->level[r->levels++] = next.n;
+		tmp = front;
+		front = next;
+		next = tmp;
+	}
+
+	if (!err && ids && r->count) {
+		size_t j = 0;
+
+		r->ids = malloc(r->count * sizeof(uint64_t));
+		if (!r->ids) exit(1);
+		for (i = 0; i <= t.mask; i++)
+			if (t.slots[i].side && t.slots[i].dist) r->ids[j++] = t.slots[i].id;
+		qsort(r->ids, j, sizeof(uint64_t), cmp_u64);
+	}
+	free(t.slots);
+	free(front.ids);
+	free(next.ids);
+	return err;
+}
+
+/*
+	Direction-optimizing BFS
+
+	A top-down step walks the edges of the frontier, which is cheap
+	while the frontier is small. On graphs with hubs the middle levels
+	hold most of the vertices, and nearly every edge out of them leads
+	somewhere already visited. A bottom-up step instead has every
+	unvisited vertex look for any neighbor in the frontier and stop at
+	the first one. The search switches to bottom-up once the frontier's
+	edges outnumber those of the unvisited vertices by BFS_ALPHA, and
+	back once the frontier shrinks below nvertices / BFS_BETA (Beamer,
+	Asanovic and Patterson). The frontier, the next frontier and the
+	visited set are bitmaps over the snapshot's vertex numbers. Ghosts
+	are walked through like any vertex, since a path may go through a
+	vertex of another partition, but only owned vertices are counted.
+*/
+
+// State of one level, shared by the chunks working on it
+typedef struct bfs_level {
+	const csr_snapshot *s;
+	uint64_t *visited;
+	uint64_t *front;
+	uint64_t *next;
+	int32_t *depth;
+	int32_t level;
+	size_t words;
+	uint64_t nf;		// vertices added to next
+	uint64_t mf;		// their edges
+	uint64_t edges;		// neighbor entries examined
+} bfs_level;
+
+static inline bool bit_test(const uint64_t *bits, size_t i) {
+	return bits[i >> 6] >> (i & 63) & 1;
+}
+
+static inline uint64_t degree(const csr_snapshot *s, size_t v) {
+	return s->offsets[v + 1] - s->offsets[v];
+}
+
+// Adds one chunk's counts to the level's
+static void bfs_count(bfs_level *l, uint64_t nf, uint64_t mf, uint64_t edges) {
+	__atomic_add_fetch(&l->nf, nf, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&l->mf, mf, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&l->edges, edges, __ATOMIC_RELAXED);
+}
+
+// pool_for body: expands the frontier vertices in words [lo, hi). A
+// neighbor may be reached from several chunks at once, so it is
+// claimed by whoever sets its visited bit first.
+static void top_down(size_t lo, size_t hi, void *arg) {
+	bfs_level *l = arg;
+	const csr_snapshot *s = l->s;
+	uint64_t nf = 0, mf = 0, edges = 0;
+	size_t w;
+
+	for (w = lo; w < hi; w++) {
+		uint64_t bits = l->front[w];
+		while (bits) {
+			size_t u = w << 6 | __builtin_ctzll(bits);
+			uint64_t k;
+			bits &= bits - 1;
+			for (k = s->offsets[u]; k < s->offsets[u + 1]; k++) {
+				uint32_t v = s->neighbors[k];
+				uint64_t bit = 1ULL << (v & 63);
+				if (__atomic_load_n(&l->visited[v >> 6], __ATOMIC_RELAXED) & bit ||
+					__atomic_fetch_or(&l->visited[v >> 6], bit, __ATOMIC_RELAXED) & bit)
+					continue;
+				__atomic_fetch_or(&l->next[v >> 6], bit, __ATOMIC_RELAXED);
+				if (l->depth) l->depth[v] = l->level;
+				nf++;
+				mf += degree(s, v);
+			}
+			edges += degree(s, u);
+		}
+	}
+	bfs_count(l, nf, mf, edges);
+}
+
+// pool_for body: looks for a parent in the frontier for every unvisited
+// vertex in words [lo, hi); only this chunk writes those words
+static void bottom_up(size_t lo, size_t hi, void *arg) {
+	bfs_level *l = arg;
+	const csr_snapshot *s = l->s;
+	size_t n = s->nvertices, w;
+	uint64_t nf = 0, mf = 0, edges = 0;
+
+	for (w = lo; w < hi; w++) {
+		uint64_t bits = ~l->visited[w], found = 0;
+		if (w == l->words - 1 && (n & 63)) bits &= (1ULL << (n & 63)) - 1;
+		while (bits) {
+			size_t v = w << 6 | __builtin_ctzll(bits);
+			uint64_t k;
+			bits &= bits - 1;
+			for (k = s->offsets[v]; k < s->offsets[v + 1]; k++) {
+				edges++;
+				if (bit_test(l->front, s->neighbors[k])) {
+					found |= 1ULL << (v & 63);
+					if (l->depth) l->depth[v] = l->level;
+					nf++;
+					mf += degree(s, v);
+					break;
+				}
+			}
+		}
+		l->visited[w] |= found;
+		l->next[w] = found;
+	}
+	bfs_count(l, nf, mf, edges);
+}
+
+// Runs a BFS over s from vertex number source, filling r; depth, if not
+// NULL, gets each vertex's distance from source, or -1 if unreachable.
+// Called on a pool worker, every level is spread over the pool.
+void bfs_run(const csr_snapshot *s, uint32_t source, int32_t *depth, bfs_result *r) {
+	size_t n = s->nvertices, w;
+	bfs_level l;
+	uint64_t mu = s->offsets[n], last_nf = 0, *tmp;
+	bool up = false;
+
+	l.s = s;
+	l.words = (n + 63) / 64;
+	l.visited = calloc(l.words, sizeof(uint64_t));
+	l.front = calloc(l.words, sizeof(uint64_t));
+	l.next = calloc(l.words, sizeof(uint64_t));
+	l.depth = depth;
+	l.level = 0;
+	l.edges = 0;
+	if (!l.visited || !l.front || !l.next) exit(1);
+	memset(r, 0, sizeof(bfs_result));
+	if (depth) {
+		memset(depth, 0xff, n * sizeof(int32_t));
+		depth[source] = 0;
+	}
+	l.visited[source >> 6] = l.front[source >> 6] = 1ULL << (source & 63);
+	l.nf = 1;
+	l.mf = degree(s, source);
+	mu -= l.mf;
+
+	while (l.nf) {
+		if (!up && l.mf > mu / BFS_ALPHA) up = true;
+		else if (up && l.nf < last_nf && l.nf < n / BFS_BETA) up = false;
+		last_nf = l.nf;
+		l.nf = l.mf = 0;
+		l.level++;
+
+		if (up) {
+			// every word of next is rewritten
+			pool_for(l.words, BFS_CHUNK, bottom_up, &l);
+			r->bottom_up++;
+		} else {
+			memset(l.next, 0, l.words * sizeof(uint64_t));
+			pool_for(l.words, BFS_CHUNK, top_down, &l);
+		}
+
+		mu -= l.mf;
+		if (l.nf) r->levels++;
+		tmp = l.front;
+		l.front = l.next;
+		l.next = tmp;
+	}
+	r->edges = l.edges;
+	// numbers that held no vertex can't be reached, but ghosts can
+	for (w = 0; w < l.words; w++) r->reached += __builtin_popcountll(l.visited[w] & s->owned[w]);
+
+	free(l.visited);
+	free(l.front);
+	free(l.next);
+}
+
+// Returns whether number i of s holds a vertex owned here
+static inline bool csr_owned(const csr_snapshot *s, int64_t i) {
+	return i >= 0 && bit_test(s->owned, i);
+}
+
+// Runs a BFS over the partition from id, filling r; returns false if id
+// isn't in the partition
+bool bfs_from(uint64_t id, bfs_result *r) {
+	csr_snapshot *s;
+	int64_t source = -1;
+
+	if (id % PARTITIONS + 1 != CHAIN_NUM || !get_node(id)) return false;
+	ebr_enter();
+	// the background thread's snapshot is used however stale, so that
+	// a run of searches during writes doesn't rebuild it once each;
+	// only a source added since needs a build, shared by every caller
+	// that waits for it
+	if ((s = csr_latest())) source = csr_find(s, id);
+	if (!s || !csr_owned(s, source)) {
+		csr_build();
+		s = csr_latest();
+		source = s ? csr_find(s, id) : -1;
+	}
+	if (s && csr_owned(s, source)) {
+		bfs_run(s, source, NULL, r);
+		r->stale = csr_fresh() != s;
+	}
+	ebr_exit();
+	return s && csr_owned(s, source);
+}
@@ -0,0 +1,240 @@
+/*
+ * csr.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides immutable compressed-sparse-row snapshots
+ * of the partition, built in the background and used
+ * for scans and for reads while the graph is unchanged
+ */
+
+#include "headers.h"
+
+extern vertex_map map;
+extern int CHAIN_NUM;
+
+/*
+	CSR snapshots
+
+	A snapshot numbers the partition's vertices by local index, 0 to
+	nvertices-1. offsets[i]..offsets[i+1] is the range of neighbors[]
+	holding vertex i's neighbors, as local indices, sorted, and ids[i]
+	is vertex i's id. Since the lists already hold local indices, they
+	are copied as they are; only a hub set has to be sorted. The owned
+	bitmap tells the vertices of this partition from ghosts and from
+	numbers that held no vertex. by_id holds the same numbers as
+	neighbors, each range reordered by id, so a page of a list can be
+	bisected out of it by its id cursor instead of scanning the list.
+
+	Building never blocks writers: vertices are walked through the
+	local index directory and each neighbor list is copied under its
+	vertex's sequence lock. A snapshot is tagged with map.version from
+	before the build and is only used to answer reads while
+	map.version still equals it, which also rules out any snapshot a
+	writer raced with.
+
+	Readers see a snapshot between ebr_enter and ebr_exit, and one
+	that is replaced is retired, so it is freed once they are all
+	gone. Builds run one at a time, and one that
+	waited for another skips if that one started from as recent a
+	version, so callers that all find the snapshot stale share a build.
+*/
+
+static csr_snapshot *current;		// published snapshot, read under ebr
+static uint64_t last_build_ms;
+static pthread_mutex_t build_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Returns the number of id in s, or -1 if it has none
+int64_t csr_find(const csr_snapshot *s, uint64_t id) {
+	vertex *v;
+	int64_t i = -1;
+
+	ebr_enter();
+	v = ret_vertex(id);
+	// in a stale snapshot the index may have held another vertex
+	if (v && v->idx < s->nvertices && s->ids[v->idx] == id) i = v->idx;
+	ebr_exit();
+	return i;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+	return (x > y) - (x < y);
+}
+
+typedef struct id_num {
+	uint64_t id;
+	uint32_t num;
+} id_num;
+
+static int cmp_id_num(const void *a, const void *b) {
+	uint64_t x = ((const id_num *) a)->id, y = ((const id_num *) b)->id;
+	return (x > y) - (x < y);
+}
+
+// Fills s->by_id, each range of s->neighbors sorted by its vertices' ids
+static void sort_by_id(csr_snapshot *s) {
+	id_num *tmp = NULL;
+	size_t cap = 0, i;
+	uint64_t j, lo, hi;
+
+	s->by_id = slab_alloc(s->nedges * sizeof(uint32_t));
+	for (i = 0; i < s->nvertices; i++) {
+		lo = s->offsets[i];
+		hi = s->offsets[i + 1];
+		if (hi - lo > cap) {
+			cap = hi - lo;
+			free(tmp);
+			tmp = malloc(cap * sizeof(id_num));
+			if (!tmp) exit(1);
+		}
+		for (j = lo; j < hi; j++) {
+			tmp[j - lo].id = s->ids[s->neighbors[j]];
+			tmp[j - lo].num = s->neighbors[j];
+		}
+		if (hi - lo > 1) qsort(tmp, hi - lo, sizeof(id_num), cmp_id_num);
+		for (j = lo; j < hi; j++) s->by_id[j] = tmp[j - lo].num;
+	}
+	free(tmp);
+}
+
+// Frees a snapshot no reader can see any more
+static void csr_retire(csr_snapshot *s) {
+	ebr_retire(s->ids, s->nvertices * sizeof(uint64_t));
+	ebr_retire(s->offsets, (s->nvertices + 1) * sizeof(uint64_t));
+	ebr_retire(s->neighbors, s->nedges * sizeof(uint32_t));
+	ebr_retire(s->by_id, s->nedges * sizeof(uint32_t));
+	ebr_retire(s->owned, (s->nvertices + 63) / 64 * sizeof(uint64_t));
+	ebr_retire(s, sizeof(csr_snapshot));
+}
+
+// Builds a snapshot of the partition and publishes it, unless one as
+// recent was published while it waited for another build
+void csr_build(void) {
+	uint64_t version = __atomic_load_n(&map.version, __ATOMIC_ACQUIRE);
+	// read after version: a vertex added since has a higher index, or
+	// a reclaimed one below n, and bumps version once it is in the
+	// directory
+	uint32_t n = __atomic_load_n(&map.next_idx, __ATOMIC_ACQUIRE);
+	struct timespec t0, t1;
+	uint32_t *nb = NULL;
+	size_t nb_cap = 0, nedges = 0, i, k;
+	csr_snapshot *s, *old;
+
+	pthread_mutex_lock(&build_lock);
+	old = __atomic_load_n(&current, __ATOMIC_ACQUIRE);
+	if (old && old->version >= version) {
+		pthread_mutex_unlock(&build_lock);
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	s = slab_alloc(sizeof(csr_snapshot));
+	s->version = version;
+	s->nvertices = n;
+	s->ids = slab_alloc(n * sizeof(uint64_t));
+	s->offsets = slab_alloc((n + 1) * sizeof(uint64_t));
+	s->owned = slab_alloc((n + 63) / 64 * sizeof(uint64_t));
+	memset(s->owned, 0, (n + 63) / 64 * sizeof(uint64_t));
+
+	ebr_enter();
+	s->offsets[0] = 0;
+	for (i = 0; i < n; i++) {
+		vertex *v = vertex_at(i);
+		adj_list l;
+		uint32_t seq;
+		size_t begin = nedges, j;
+
+		// still being added: this snapshot is stale anyway
+		if (!v) {
+			s->ids[i] = 0;
+			s->offsets[i + 1] = nedges;
+			continue;
+		}
+		s->ids[i] = v->id;
+		if (v->id % PARTITIONS + 1 == CHAIN_NUM) s->owned[i >> 6] |= 1ULL << (i & 63);
+		do {
+			seq = adj_snapshot(v, &l);
+			if (nedges + l.n > nb_cap) {
+				while (nedges + l.n > nb_cap) nb_cap = nb_cap ? nb_cap * 2 : 4096;
+				nb = realloc(nb, nb_cap * sizeof(uint32_t));
+				if (!nb) exit(1);
+			}
+			adj_copy(&l, nb + nedges);
+		} while (!read_valid(v, seq));
+		// neighbors added after n was read: stale as well
+		for (j = k = begin; j < begin + l.n; j++)
+			if (nb[j] < n) nb[k++] = nb[j];
+		if (l.hub) qsort(nb + begin, k - begin, sizeof(uint32_t), cmp_u32);
+		nedges = k;
+		s->offsets[i + 1] = nedges;
+	}
+	ebr_exit();
+
+	s->neighbors = slab_alloc(nedges * sizeof(uint32_t));
+	if (nedges) memcpy(s->neighbors, nb, nedges * sizeof(uint32_t));
+	s->nedges = nedges;
+	free(nb);
+	sort_by_id(s);
+
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	last_build_ms = (t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000;
+
+	old = __atomic_exchange_n(&current, s, __ATOMIC_ACQ_REL);
+	if (old) csr_retire(old);
+	pthread_mutex_unlock(&build_lock);
+}
+
+// Returns the published snapshot if no write has happened since it was
+// built, NULL otherwise; call inside ebr_enter/ebr_exit
+csr_snapshot *csr_fresh(void) {
+	csr_snapshot *s = __atomic_load_n(&current, __ATOMIC_ACQUIRE);
+
+	if (s && s->version == __atomic_load_n(&map.version, __ATOMIC_ACQUIRE))
+		return s;
+	return NULL;
+}
+
+// Returns the published snapshot, however stale; call inside ebr_enter/ebr_exit
+csr_snapshot *csr_latest(void) {
+	return __atomic_load_n(&current, __ATOMIC_ACQUIRE);
+}
+
+// Returns the version of the published snapshot and how long it took to build
+uint64_t csr_stats(uint64_t *build_ms) {
+	csr_snapshot *s;
+	uint64_t version = 0;
+
+	ebr_enter();
+	s = csr_latest();
+	if (s) version = s->version;
+	ebr_exit();
+	*build_ms = last_build_ms;
+	return version;
+}
+
+// Background thread: rebuilds once CSR_REBUILD_DELTA writes have piled
+// up, or sooner once writes go quiet so reads can use the snapshot
+void *csr_thread(void *arg) {
+	uint64_t seen = 0;
+
+	for (;;) {
+		uint64_t version = __atomic_load_n(&map.version, __ATOMIC_ACQUIRE);
+		uint64_t built = 0;
+		csr_snapshot *s;
+
+		usleep(CSR_INTERVAL_MS * 1000);
+		ebr_enter();
+		s = csr_latest();
+		if (s) built = s->version;
+		ebr_exit();
+
+		if ((!s || version != built) &&
+			(version - built >= CSR_REBUILD_DELTA || version == seen))
+			csr_build();
+		seen = version;
+		ebr_flush();
+	}
+	return NULL;
+}
@@ -0,0 +1,177 @@
+/*
+ * epoch.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides epoch-based reclamation, so that readers can
+ * walk the graph store without locks while writers
+ * replace and free the memory underneath them
+ */
+
+#include "headers.h"
+
+/*
+	Epoch-based reclamation
+
+	A reader brackets its accesses with ebr_enter/ebr_exit, which
+	announce the global epoch it started in. Writers unlink memory
+	first and then hand it to ebr_retire instead of freeing it. The
+	global epoch only advances once every thread inside a critical
+	section has announced the current one, so memory retired in
+	epoch e can be freed once the epoch reaches e + 2: nobody who
+	could still hold a pointer to it is left.
+*/
+
+// Retired allocation waiting for two epoch advances
+typedef struct ebr_node {
+	void *p;
+	size_t size;
+	struct ebr_node *next;
+} ebr_node;
+
+// Per-thread reclamation state; records are never unlinked, only reused
+typedef struct ebr_thread {
+	uint64_t epoch;			// announced epoch << 1 | 1 while inside
+	uint32_t nest;			// nested ebr_enter calls
+	bool in_use;
+	struct ebr_thread *next;
+	ebr_node *limbo[3];		// retired lists, by epoch % 3
+	uint64_t limbo_epoch[3];	// epoch each list was retired in
+	size_t pending;
+} ebr_thread;
+
+static uint64_t global_epoch = 1;
+static ebr_thread *threads;
+static __thread ebr_thread *self;
+static pthread_key_t self_key;
+static pthread_once_t self_once = PTHREAD_ONCE_INIT;
+
+// Marks an exiting thread's record free; its limbo lists go with it
+// to whichever thread picks the record up next
+static void ebr_thread_exit(void *arg) {
+	ebr_thread *t = arg;
+	__atomic_store_n(&t->epoch, 0, __ATOMIC_RELEASE);
+	t->nest = 0;
+	__atomic_store_n(&t->in_use, false, __ATOMIC_RELEASE);
+}
+
+static void ebr_make_key(void) {
+	pthread_key_create(&self_key, ebr_thread_exit);
+}
+
+// Returns this thread's record, claiming a free one or adding a new one
+static ebr_thread *ebr_self(void) {
+	ebr_thread *t;
+
+	if (self) return self;
+	pthread_once(&self_once, ebr_make_key);
+
+	for (t = __atomic_load_n(&threads, __ATOMIC_ACQUIRE); t; t = t->next) {
+		bool expected = false;
+		if (!__atomic_load_n(&t->in_use, __ATOMIC_RELAXED) &&
+			__atomic_compare_exchange_n(&t->in_use, &expected, true, false,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) break;
+	}
+	if (!t) {
+		t = calloc(1, sizeof(ebr_thread));
+		if (!t) exit(1);
+		t->in_use = true;
+		t->next = __atomic_load_n(&threads, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&threads, &t->next, t, false,
+			__ATOMIC_RELEASE, __ATOMIC_RELAXED));
+	}
+	pthread_setspecific(self_key, t);
+	self = t;
+	return t;
+}
+
+// Starts a read-side critical section; may be nested
+void ebr_enter(void) {
+	ebr_thread *t = ebr_self();
+
+	if (t->nest++) return;
+	// the store must be visible before any of the reader's loads
+	__atomic_store_n(&t->epoch,
+		__atomic_load_n(&global_epoch, __ATOMIC_RELAXED) << 1 | 1,
+		__ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// Ends a read-side critical section
+void ebr_exit(void) {
+	ebr_thread *t = self;
+
+	if (--t->nest) return;
+	__atomic_store_n(&t->epoch, 0, __ATOMIC_RELEASE);
+}
+
+// Advances the global epoch if every active thread has caught up
+static void ebr_try_advance(void) {
+	uint64_t e = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+	ebr_thread *t;
+
+	for (t = __atomic_load_n(&threads, __ATOMIC_ACQUIRE); t; t = t->next) {
+		uint64_t announced = __atomic_load_n(&t->epoch, __ATOMIC_SEQ_CST);
+		if ((announced & 1) && (announced >> 1) != e) return;
+	}
+	__atomic_compare_exchange_n(&global_epoch, &e, e + 1, false,
+		__ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+// Frees a limbo list
+static void ebr_free_list(ebr_node *n) {
+	while (n) {
+		ebr_node *next = n->next;
+		slab_free(n->p, n->size);
+		slab_free(n, sizeof(ebr_node));
+		n = next;
+	}
+}
+
+// Frees p (size bytes from slab_alloc) once no reader can still see it
+void ebr_retire(void *p, size_t size) {
+	ebr_thread *t = ebr_self();
+	uint64_t e = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+	int i = e % 3;
+	ebr_node *n;
+
+	if (!p) return;
+	// this list last took retirees in epoch e - 3 or earlier, which
+	// is at least two advances ago
+	if (t->limbo_epoch[i] != e) {
+		ebr_free_list(t->limbo[i]);
+		t->limbo[i] = NULL;
+		t->limbo_epoch[i] = e;
+	}
+	n = slab_alloc(sizeof(ebr_node));
+	n->p = p;
+	n->size = size;
+	n->next = t->limbo[i];
+	t->limbo[i] = n;
+
+	if (++t->pending % EBR_BATCH == 0) ebr_try_advance();
+}
+
+// Advances the global epoch if it can, and returns it; whatever was
+// given up in epoch e is out of every reader's hands once this is e + 2
+uint64_t ebr_epoch(void) {
+	ebr_try_advance();
+	return __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+}
+
+// Frees whatever this thread retired that is now safe
+void ebr_flush(void) {
+	ebr_thread *t = ebr_self();
+	uint64_t e;
+	int i;
+
+	ebr_try_advance();
+	e = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+	for (i = 0; i < 3; i++) {
+		if (t->limbo[i] && t->limbo_epoch[i] + 2 <= e) {
+			ebr_free_list(t->limbo[i]);
+			t->limbo[i] = NULL;
+		}
+	}
+}
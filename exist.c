@@ -0,0 +1,243 @@
+/*
+ * exist.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides a roaring bitmap of the vertices in the
+ * partition, so that existence checks don't have to
+ * go through the vertex table
+ */
+
+#include "headers.h"
+
+/*
+	Existence set
+
+	A compressed bitmap of the ids owned here, kept next to the vertex
+	table so that get_node and the endpoint checks of add_edge and
+	get_edge cost a chunk lookup in a small table and one read of the
+	chunk, rather than a probe of the vertex table. A partition owns
+	every PARTITIONS-th id, so ids are split by residue and divided by
+	PARTITIONS first, which turns a dense range of ids into a dense
+	range of positions. Position p is bit p & 0xffff of chunk p >> 16
+	of its residue; chunks are found through an id_table.
+
+	As in a roaring bitmap, a chunk is a sorted array of up to
+	EXIST_ARRAY_MAX 16-bit values, then a bitmap of 65536 bits, and
+	once all of them are set, nothing at all. Vertices are never
+	removed, so the set only grows. Writers of a chunk take one of
+	EXIST_LOCKS locks, picked by its hash, so a chunk is just a pointer;
+	chunks are made under their residue's lock. Readers take no lock.
+	A value past the end of an array is written before the count that
+	covers it, a value inside goes into a copy that replaces the array,
+	and a bit is set in place. Whatever is replaced is retired.
+*/
+
+// Kinds of chunk body
+#define EXIST_ARRAY (0)
+#define EXIST_BITMAP (1)
+#define EXIST_FULL (2)
+
+// Words of a bitmap body
+#define EXIST_WORDS ((1 << 16) / 64)
+
+// A chunk's values: a sorted array or a bitmap, replaced whole when it
+// changes kind or an array grows
+typedef struct exist_body {
+	uint32_t kind;
+	uint32_t n;		// values set; an array's readers go by it
+	uint32_t cap;		// array only: values allocated
+	uint32_t pad;
+	uint64_t data[];	// uint16_t values, or EXIST_WORDS words
+} exist_body;
+
+// The bitmap of 65536 ids sharing a residue and position >> 16
+typedef struct exist_chunk {
+	exist_body *body;
+} exist_chunk;
+
+static struct {
+	id_table chunks[PARTITIONS];	// by residue: position >> 16 -> chunk
+	pthread_mutex_t lock[PARTITIONS];	// serializes chunk creation
+	pthread_mutex_t chunk_lock[EXIST_LOCKS];	// writers of chunks, by hash
+	size_t bytes;			// chunks and bodies allocated
+} set;
+
+// What a chunk with all 65536 values points to
+static exist_body exist_full = { EXIST_FULL, 1 << 16, 0, 0 };
+
+// Returns the bytes a body takes
+static inline size_t body_size(const exist_body *b) {
+	if (b->kind == EXIST_FULL) return 0;
+	if (b->kind == EXIST_BITMAP) return sizeof(exist_body) + EXIST_WORDS * sizeof(uint64_t);
+	return sizeof(exist_body) + b->cap * sizeof(uint16_t);
+}
+
+static exist_body *body_alloc(uint32_t kind, uint32_t cap) {
+	exist_body *b;
+	size_t size = sizeof(exist_body) +
+		(kind == EXIST_BITMAP ? EXIST_WORDS * sizeof(uint64_t) : cap * sizeof(uint16_t));
+
+	b = slab_alloc(size);
+	memset(b, 0, size);
+	b->kind = kind;
+	b->cap = kind == EXIST_ARRAY ? cap : 0;
+	__atomic_add_fetch(&set.bytes, size, __ATOMIC_RELAXED);
+	return b;
+}
+
+static void body_retire(exist_body *b) {
+	size_t size = body_size(b);
+
+	if (!size) return;
+	__atomic_sub_fetch(&set.bytes, size, __ATOMIC_RELAXED);
+	ebr_retire(b, size);
+}
+
+// Returns index of the first of the n sorted values that is >= v
+static inline uint32_t lower_bound16(const uint16_t *vals, uint32_t n, uint16_t v) {
+	uint32_t lo = 0, hi = n;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (vals[mid] < v) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// Returns true if b holds v
+static bool body_test(const exist_body *b, uint16_t v) {
+	const uint16_t *vals;
+	uint32_t n, i;
+
+	switch (b->kind) {
+		case EXIST_FULL:
+			return true;
+		case EXIST_BITMAP:
+			return __atomic_load_n(&b->data[v >> 6], __ATOMIC_RELAXED) >> (v & 63) & 1;
+	}
+	n = __atomic_load_n(&b->n, __ATOMIC_ACQUIRE);
+	vals = (const uint16_t *) b->data;
+	i = lower_bound16(vals, n, v);
+	return i < n && vals[i] == v;
+}
+
+// Publishes b as c's body, retiring the old one
+static void chunk_replace(exist_chunk *c, exist_body *b) {
+	exist_body *old = c->body;
+
+	__atomic_store_n(&c->body, b, __ATOMIC_RELEASE);
+	body_retire(old);
+}
+
+// Adds v to c; c's chunk lock is held
+static void chunk_add(exist_chunk *c, uint16_t v) {
+	exist_body *b = c->body, *nb;
+	uint16_t *vals = (uint16_t *) b->data;
+	uint32_t i, k;
+
+	if (b->kind == EXIST_FULL) return;
+	if (b->kind == EXIST_BITMAP) {
+		uint64_t bit = 1ULL << (v & 63);
+		if (b->data[v >> 6] & bit) return;
+		__atomic_store_n(&b->data[v >> 6], b->data[v >> 6] | bit, __ATOMIC_RELAXED);
+		if (++b->n == 1 << 16) chunk_replace(c, &exist_full);
+		return;
+	}
+
+	i = lower_bound16(vals, b->n, v);
+	if (i < b->n && vals[i] == v) return;
+	// ids are mostly added in order: append in place
+	if (i == b->n && b->n < b->cap) {
+		vals[i] = v;
+		__atomic_store_n(&b->n, b->n + 1, __ATOMIC_RELEASE);
+		return;
+	}
+	if (b->n == EXIST_ARRAY_MAX) {
+		nb = body_alloc(EXIST_BITMAP, 0);
+		for (k = 0; k < b->n; k++) nb->data[vals[k] >> 6] |= 1ULL << (vals[k] & 63);
+		nb->data[v >> 6] |= 1ULL << (v & 63);
+		nb->n = b->n + 1;
+	} else {
+		uint32_t cap = b->n < b->cap ? b->cap : b->cap * 2;
+		uint16_t *out;
+		if (cap > EXIST_ARRAY_MAX) cap = EXIST_ARRAY_MAX;
+		nb = body_alloc(EXIST_ARRAY, cap);
+		out = (uint16_t *) nb->data;
+		memcpy(out, vals, i * sizeof(uint16_t));
+		out[i] = v;
+		memcpy(out + i + 1, vals + i, (b->n - i) * sizeof(uint16_t));
+		nb->n = b->n + 1;
+	}
+	chunk_replace(c, nb);
+}
+
+// Initializes the empty set; called by init_map
+void exist_init(void) {
+	int r;
+
+	for (r = 0; r < PARTITIONS; r++) {
+		idt_init(&set.chunks[r], 16);
+		pthread_mutex_init(&set.lock[r], NULL);
+	}
+	for (r = 0; r < EXIST_LOCKS; r++) pthread_mutex_init(&set.chunk_lock[r], NULL);
+	set.bytes = 0;
+}
+
+// Adds id; the caller holds the write lock of id's stripe
+void exist_add(uint64_t id) {
+	int r = id % PARTITIONS;
+	uint64_t p = id / PARTITIONS;
+	pthread_mutex_t *lock = &set.chunk_lock[hash_vertex(p >> 16 ^ r) % EXIST_LOCKS];
+	exist_chunk *c;
+
+	ebr_enter();
+	c = idt_find(&set.chunks[r], p >> 16);
+	if (!c) {
+		// vertices of other stripes may share the chunk
+		pthread_mutex_lock(&set.lock[r]);
+		c = idt_find(&set.chunks[r], p >> 16);
+		if (!c) {
+			c = slab_alloc(sizeof(exist_chunk));
+			c->body = body_alloc(EXIST_ARRAY, EXIST_ARRAY_INIT);
+			__atomic_add_fetch(&set.bytes, sizeof(exist_chunk), __ATOMIC_RELAXED);
+			idt_insert(&set.chunks[r], p >> 16, c);
+		}
+		pthread_mutex_unlock(&set.lock[r]);
+	}
+	pthread_mutex_lock(lock);
+	chunk_add(c, p & 0xffff);
+	pthread_mutex_unlock(lock);
+	ebr_exit();
+}
+
+// Returns true if id is in the set; needs no lock
+bool exist_test(uint64_t id) {
+	uint64_t p = id / PARTITIONS;
+	exist_chunk *c;
+	bool found = false;
+
+	ebr_enter();
+	c = idt_find(&set.chunks[id % PARTITIONS], p >> 16);
+	if (c) found = body_test(__atomic_load_n(&c->body, __ATOMIC_ACQUIRE), p & 0xffff);
+	ebr_exit();
+	return found;
+}
+
+// Returns the bytes the set takes: its chunks, their bodies and the
+// tables that find them
+size_t exist_bytes(void) {
+	size_t bytes = __atomic_load_n(&set.bytes, __ATOMIC_RELAXED);
+	int r;
+
+	ebr_enter();
+	for (r = 0; r < PARTITIONS; r++) {
+		id_array *cur = __atomic_load_n(&set.chunks[r].cur, __ATOMIC_ACQUIRE);
+		id_array *old = __atomic_load_n(&set.chunks[r].old, __ATOMIC_ACQUIRE);
+		bytes += cur->cap * (sizeof(id_slot) + 1);
+		if (old) bytes += old->cap * (sizeof(id_slot) + 1);
+	}
+	ebr_exit();
+	return bytes;
+}
@@ -0,0 +1,440 @@
+/*
+ * filter.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides cuckoo filters of the vertices each partition
+ * owns, shipped to the other partitions so that they can
+ * turn away missing endpoints without asking
+ */
+
+#include "headers.h"
+
+extern vertex_map map;
+extern int CHAIN_NUM;
+
+/*
+	Peer filters
+
+	Before an edge across partitions is added or looked up, the owner of
+	the far endpoint is asked whether it has it, which costs a round
+	trip even when the answer is no. So each partition keeps a cuckoo
+	filter of the vertices it owns, ghosts left out, and ships a copy to
+	the others; an id the copy doesn't hold is certainly missing there.
+	A bucket is one word of FILTER_SLOTS 16-bit fingerprints; an id goes
+	into one of two buckets, the second found from the first and its
+	fingerprint, so fingerprints can be moved, and removed, without the
+	ids. When an insert can't make room, the filter is rebuilt twice as
+	big from the vertices of the partition.
+
+	A copy must never miss a vertex its owner has acknowledged. Each
+	copy carries the generation of the filter it was taken from, and a
+	peer ignores copies older than the newest generation it heard of.
+	The first insert after a copy went out that the copy may not
+	answer, as it doesn't answer the id yet or fingerprints have to
+	move, asks for a drop under a new generation. Inserts run under
+	stripe locks, so the drop is left to the background thread, which
+	tells every peer to drop its copy; whoever acknowledges the new
+	vertex first waits in filter_sync, with no lock held, until each
+	peer has taken the drop or a newer copy, or can't hold a copy any
+	more since the last one sent to it has expired. A peer that can't
+	be reached is retried every FILTER_PUSH_MS until then, and gets no
+	new copy meanwhile, so a hung one holds acknowledgements up for
+	FILTER_TTL_MS at most; every push has a deadline. Removals need
+	nothing: a copy that still holds an id only costs an RPC. The
+	thread also ships the filter once changes to it have gone quiet,
+	and again every FILTER_REFRESH_MS; a peer stops trusting a copy
+	FILTER_TTL_MS after it came.
+*/
+
+// A fingerprint in every slot of a bucket
+#define FILTER_LANES (0x0001000100010001ULL)
+
+// A peer's filter, as shipped; never changed once published
+typedef struct filter_copy {
+	uint64_t nbuckets;
+	uint64_t expires;	// monotonic ms after which it isn't trusted
+	uint64_t table[];
+} filter_copy;
+
+// The filter of the vertices owned here
+static struct {
+	pthread_mutex_t lock;	// serializes writers and the thread shipping it
+	uint64_t *table;	// nbuckets buckets
+	uint64_t nbuckets;
+	uint64_t count;		// fingerprints held
+	uint64_t version;	// changes so far
+	uint64_t gen;		// last generation handed out, to a copy or a drop
+	uint64_t shipped;	// generation of the newest copy sent, 0 if none
+	uint64_t drop;		// generation of the newest drop asked for
+	uint64_t dropped;	// generation of the newest drop all peers took
+	pthread_cond_t wake;	// a drop is waiting to be sent
+	pthread_cond_t settled;	// dropped moved
+	uint64_t seed;		// picks the fingerprint to evict
+} own;
+
+// The copies of the other partitions' filters
+static struct {
+	pthread_mutex_t lock;	// serializes their replacement
+	uint64_t gen;		// newest generation heard of
+	filter_copy *copy;	// NULL if none
+} peer[PARTITIONS + 1];
+
+static uint64_t lookups, negatives, false_positives;
+
+static inline int owner(uint64_t id) {
+	return id % PARTITIONS + 1;
+}
+
+static uint64_t now_ms(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t) t.tv_sec * 1000 + t.tv_nsec / 1000000;
+}
+
+// Returns the fingerprint of an id with hash h; never 0, which marks a
+// free slot
+static inline uint64_t fingerprint(uint64_t h) {
+	uint64_t fp = h >> 48;
+	return fp ? fp : 1;
+}
+
+// Returns the other bucket of fingerprint fp in bucket i
+static inline uint64_t alt_bucket(uint64_t i, uint64_t fp, uint64_t nbuckets) {
+	return (i ^ hash_vertex(fp)) & (nbuckets - 1);
+}
+
+// Returns true if bucket b holds fp, checking its slots at once
+static inline bool bucket_has(uint64_t b, uint64_t fp) {
+	uint64_t x = b ^ fp * FILTER_LANES;
+	return ((x - FILTER_LANES) & ~x & FILTER_LANES << 15) != 0;
+}
+
+// Puts fp in a free slot of *b; returns false if there is none
+static bool bucket_put(uint64_t *b, uint64_t fp) {
+	int k;
+
+	for (k = 0; k < FILTER_SLOTS; k++) {
+		if (!(*b >> 16 * k & 0xffff)) {
+			*b |= fp << 16 * k;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Clears a slot of *b holding fp; returns false if there is none
+static bool bucket_clear(uint64_t *b, uint64_t fp) {
+	int k;
+
+	for (k = 0; k < FILTER_SLOTS; k++) {
+		if ((*b >> 16 * k & 0xffff) == fp) {
+			*b &= ~(0xffffULL << 16 * k);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Returns true if an id with hash h may be in the table
+static inline bool table_has(const uint64_t *table, uint64_t nbuckets, uint64_t h) {
+	uint64_t fp = fingerprint(h), i = h & (nbuckets - 1);
+	return bucket_has(table[i], fp) || bucket_has(table[alt_bucket(i, fp, nbuckets)], fp);
+}
+
+// Inserts an id with hash h, evicting fingerprints to their other bucket
+// as needed; returns false if the table was too full, which loses a
+// fingerprint, so the table has to be rebuilt. The lock is held.
+static bool table_insert(uint64_t *table, uint64_t nbuckets, uint64_t h) {
+	uint64_t fp = fingerprint(h), i = h & (nbuckets - 1), victim;
+	int kick, k;
+
+	if (bucket_put(&table[i], fp)) return true;
+	i = alt_bucket(i, fp, nbuckets);
+	if (bucket_put(&table[i], fp)) return true;
+	for (kick = 0; kick < FILTER_MAX_KICKS; kick++) {
+		own.seed ^= own.seed << 13;
+		own.seed ^= own.seed >> 7;
+		own.seed ^= own.seed << 17;
+		k = own.seed % FILTER_SLOTS;
+		victim = table[i] >> 16 * k & 0xffff;
+		table[i] = (table[i] & ~(0xffffULL << 16 * k)) | fp << 16 * k;
+		fp = victim;
+		i = alt_bucket(i, fp, nbuckets);
+		if (bucket_put(&table[i], fp)) return true;
+	}
+	return false;
+}
+
+// Rebuilds the filter with twice the buckets, or more if need be, from
+// the vertices owned here; the lock is held
+static void filter_grow(void) {
+	uint64_t nbuckets = own.nbuckets, count, *table;
+	uint32_t n, idx;
+	bool fits;
+
+	do {
+		nbuckets *= 2;
+		table = slab_alloc(nbuckets * sizeof(uint64_t));
+		memset(table, 0, nbuckets * sizeof(uint64_t));
+		// read after the caller's vertex was indexed, so it is below n
+		n = __atomic_load_n(&map.next_idx, __ATOMIC_ACQUIRE);
+		fits = true;
+		count = 0;
+		for (idx = 0; idx < n && fits; idx++) {
+			vertex *v = vertex_at(idx);
+			// one being added right now inserts itself once it has the lock
+			if (!v || owner(v->id) != CHAIN_NUM) continue;
+			fits = table_insert(table, nbuckets, hash_vertex(v->id));
+			count++;
+		}
+		if (!fits) slab_free(table, nbuckets * sizeof(uint64_t));
+	} while (!fits);
+	slab_free(own.table, own.nbuckets * sizeof(uint64_t));
+	own.table = table;
+	own.nbuckets = nbuckets;
+	own.count = count;
+}
+
+// Asks for the peers' copies to be dropped before a change they don't
+// cover is acknowledged, unless a drop that will do is pending; the
+// lock is held
+static void filter_invalidate(void) {
+	// no copy went out since the last drop asked for, or ever
+	if (own.shipped <= own.drop) return;
+	own.drop = ++own.gen;
+	pthread_cond_signal(&own.wake);
+}
+
+// Sets up the empty filter; called by init_map
+void filter_init(void) {
+	struct timespec t;
+	int p;
+
+	pthread_mutex_init(&own.lock, NULL);
+	pthread_cond_init(&own.wake, NULL);
+	pthread_cond_init(&own.settled, NULL);
+	own.nbuckets = FILTER_INIT_BUCKETS;
+	own.table = slab_alloc(own.nbuckets * sizeof(uint64_t));
+	memset(own.table, 0, own.nbuckets * sizeof(uint64_t));
+	own.count = 0;
+	own.version = 0;
+	// generations go on growing across restarts, so peers take the new copies
+	clock_gettime(CLOCK_REALTIME, &t);
+	own.gen = (uint64_t) t.tv_sec * 1000000000 + t.tv_nsec;
+	own.shipped = 0;
+	own.drop = 0;
+	own.dropped = 0;
+	own.seed = own.gen | 1;
+	for (p = 0; p <= PARTITIONS; p++) {
+		pthread_mutex_init(&peer[p].lock, NULL);
+		peer[p].gen = 0;
+		peer[p].copy = NULL;
+	}
+}
+
+// Adds id, if this partition owns it; the caller holds the write lock
+// of id's stripe, and id can be found already
+void filter_add(uint64_t id) {
+	uint64_t h = hash_vertex(id), fp = fingerprint(h), i;
+	bool covered;
+
+	if (owner(id) != CHAIN_NUM) return;
+	pthread_mutex_lock(&own.lock);
+	i = h & (own.nbuckets - 1);
+	// an id the filter answers already, put in a free slot, moves nothing,
+	// so the copies out there answer it too
+	covered = table_has(own.table, own.nbuckets, h) &&
+		(bucket_put(&own.table[i], fp) ||
+		bucket_put(&own.table[alt_bucket(i, fp, own.nbuckets)], fp));
+	if (covered) {
+		own.count++;
+	} else if (10 * (own.count + 1) > 9 * FILTER_SLOTS * own.nbuckets ||
+		!table_insert(own.table, own.nbuckets, h)) {
+		// beyond 90% full inserts start to fail
+		filter_grow();
+	} else {
+		own.count++;
+	}
+	own.version++;
+	if (!covered) filter_invalidate();
+	pthread_mutex_unlock(&own.lock);
+}
+
+// Removes id, if this partition owns it
+void filter_remove(uint64_t id) {
+	uint64_t h = hash_vertex(id), fp = fingerprint(h), i;
+
+	if (owner(id) != CHAIN_NUM) return;
+	pthread_mutex_lock(&own.lock);
+	i = h & (own.nbuckets - 1);
+	if (bucket_clear(&own.table[i], fp) ||
+		bucket_clear(&own.table[alt_bucket(i, fp, own.nbuckets)], fp)) {
+		own.count--;
+		own.version++;
+	}
+	pthread_mutex_unlock(&own.lock);
+}
+
+// Waits until no peer can hold a copy that misses a vertex added
+// before the call; call with no lock held, before acknowledging adds
+void filter_sync(void) {
+	uint64_t target;
+
+	pthread_mutex_lock(&own.lock);
+	target = own.drop;
+	while (own.dropped < target) pthread_cond_wait(&own.settled, &own.lock);
+	pthread_mutex_unlock(&own.lock);
+}
+
+// Returns what the filter of the partition owning id says about it
+int filter_lookup(uint64_t id) {
+	int p = owner(id), said = FILTER_NONE;
+	filter_copy *c;
+
+	if (p == CHAIN_NUM) return FILTER_NONE;
+	ebr_enter();
+	c = __atomic_load_n(&peer[p].copy, __ATOMIC_ACQUIRE);
+	if (c && now_ms() < c->expires) {
+		said = table_has(c->table, c->nbuckets, hash_vertex(id)) ? FILTER_MAYBE : FILTER_ABSENT;
+		__atomic_add_fetch(&lookups, 1, __ATOMIC_RELAXED);
+		if (said == FILTER_ABSENT) __atomic_add_fetch(&negatives, 1, __ATOMIC_RELAXED);
+	}
+	ebr_exit();
+	return said;
+}
+
+// Counts a lookup that said FILTER_MAYBE for an id its owner didn't have
+void filter_false_positive(void) {
+	__atomic_add_fetch(&false_positives, 1, __ATOMIC_RELAXED);
+}
+
+// Takes in a filter shipped by another partition: its partition,
+// generation and buckets, then the buckets; with no buckets the copy
+// held is dropped
+void filter_receive(const uint64_t *words, size_t n) {
+	filter_copy *c = NULL, *old;
+	uint64_t gen, nbuckets;
+	int p;
+
+	if (n < 3) return;
+	p = (int) words[0];
+	gen = words[1];
+	nbuckets = words[2];
+	if (p < 1 || p > PARTITIONS || p == CHAIN_NUM) return;
+	if (n != 3 + nbuckets || (nbuckets & (nbuckets - 1))) return;
+	if (nbuckets) {
+		c = slab_alloc(sizeof(filter_copy) + nbuckets * sizeof(uint64_t));
+		c->nbuckets = nbuckets;
+		c->expires = now_ms() + FILTER_TTL_MS;
+		memcpy(c->table, words + 3, nbuckets * sizeof(uint64_t));
+	}
+
+	pthread_mutex_lock(&peer[p].lock);
+	// a copy taken before a drop we already had
+	if (gen < peer[p].gen) {
+		pthread_mutex_unlock(&peer[p].lock);
+		if (c) slab_free(c, sizeof(filter_copy) + nbuckets * sizeof(uint64_t));
+		return;
+	}
+	peer[p].gen = gen;
+	old = peer[p].copy;
+	__atomic_store_n(&peer[p].copy, c, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&peer[p].lock);
+	if (old) ebr_retire(old, sizeof(filter_copy) + old->nbuckets * sizeof(uint64_t));
+}
+
+// Returns the lookups answered by a copy, and sets *negatives and
+// *false_positives to those that saved an RPC and those that didn't
+// need one
+uint64_t filter_stats(uint64_t *neg, uint64_t *fp) {
+	*neg = __atomic_load_n(&negatives, __ATOMIC_RELAXED);
+	*fp = __atomic_load_n(&false_positives, __ATOMIC_RELAXED);
+	return __atomic_load_n(&lookups, __ATOMIC_RELAXED);
+}
+
+// Background thread: ships the filter once changes to it have gone
+// quiet for FILTER_PUSH_MS, or every FILTER_REFRESH_MS regardless, and
+// sends the drops filter_add asks for as soon as they are asked
+void *filter_thread(void *arg) {
+	uint64_t seen = 0, shipped = 0, last = 0, tick = 0, *words = NULL;
+	// by peer: newest generation it took, and when every copy sent to
+	// it has expired
+	uint64_t took[PARTITIONS + 1] = {0}, expired[PARTITIONS + 1] = {0};
+	uint64_t gen = 0, drop, sent = 0, drop_words[3];
+	size_t n = 0;
+	int p;
+
+	for (;;) {
+		uint64_t version, now;
+		bool due = false, settled = true;
+		struct timespec until;
+
+		pthread_mutex_lock(&own.lock);
+		// a drop not tried yet goes right away, failed ones once a tick
+		if (own.drop <= own.dropped || own.drop == sent) {
+			clock_gettime(CLOCK_REALTIME, &until);
+			until.tv_nsec += FILTER_PUSH_MS * 1000000L;
+			until.tv_sec += until.tv_nsec / 1000000000;
+			until.tv_nsec %= 1000000000;
+			pthread_cond_timedwait(&own.wake, &own.lock, &until);
+		}
+		now = now_ms();
+		if (now - tick >= FILTER_PUSH_MS) {
+			tick = now;
+			version = own.version;
+			if (version != shipped) due = version == seen;
+			else due = now - last >= FILTER_REFRESH_MS;
+			seen = version;
+			// too big to ship: peers let their copies expire and ask instead
+			if (own.nbuckets > FILTER_SHIP_MAX) due = false;
+		}
+		if (due) {
+			n = 3 + own.nbuckets;
+			words = malloc(n * sizeof(uint64_t));
+			if (!words) exit(1);
+			words[0] = CHAIN_NUM;
+			words[1] = gen = ++own.gen;
+			words[2] = own.nbuckets;
+			memcpy(words + 3, own.table, own.nbuckets * sizeof(uint64_t));
+			own.shipped = gen;
+			shipped = version;
+			last = now;
+		}
+		drop = own.drop > own.dropped ? own.drop : 0;
+		pthread_mutex_unlock(&own.lock);
+
+		for (p = 1; p <= PARTITIONS; p++) {
+			if (p == CHAIN_NUM || !partition_ip(p)) continue;
+			// a peer that owes a drop gets only the drop: a copy that
+			// timed out would be trusted there for another
+			// FILTER_TTL_MS, and hold the acknowledgements up as long
+			if (due && !(drop && took[p] < drop)) {
+				int got = send_filter(p, words, n);
+				// a copy that may have got there is trusted there until
+				// it expires, even if the reply was lost
+				if (got != PUSH_UNSENT) expired[p] = now_ms() + FILTER_TTL_MS;
+				if (got == PUSH_TAKEN && gen > took[p]) took[p] = gen;
+			}
+			if (drop && took[p] < drop && now_ms() < expired[p]) {
+				drop_words[0] = CHAIN_NUM;
+				drop_words[1] = drop;
+				drop_words[2] = 0;
+				if (send_filter(p, drop_words, 3) == PUSH_TAKEN) took[p] = drop;
+			}
+			if (drop && took[p] < drop && now_ms() < expired[p]) settled = false;
+		}
+		if (due) free(words);
+		sent = drop;
+
+		if (drop && settled) {
+			pthread_mutex_lock(&own.lock);
+			if (drop > own.dropped) own.dropped = drop;
+			pthread_cond_broadcast(&own.settled);
+			pthread_mutex_unlock(&own.lock);
+		}
+		ebr_flush();
+	}
+	return NULL;
+}
@@ -4,205 +4,1673 @@
  * by Stylianos Rousoglou
  * and Alex Saiontz
  *
- * Provides hashtable, linked list, and
- * queue functionality, as well as a 
+ * Provides hashtable, adjacency list, slab
+ * allocator and queue functionality, as well as a 
  * shortest path alogirthm
  */
 
 #include "headers.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/*
+	Slab allocator API
+
+	Every vertex, neighbor array and index array in the store comes
+	from here. Requests are rounded up to a size class and carved out
+	of SLAB_BYTES slabs mapped straight from the OS, so same-sized
+	records pack together instead of fragmenting the malloc heap.
+	Each thread keeps a short free list per class and only takes the
+	class lock to move SLAB_BATCH objects at a time. Requests above
+	SLAB_MAX go to malloc.
+*/
+
+// Freed object, linked through its first word
+typedef struct slab_obj {
+	struct slab_obj *next;
+} slab_obj;
+
+// Shared state of one size class
+typedef struct slab_class {
+	pthread_mutex_t lock;
+	slab_obj *free;		// objects returned by thread caches
+	char *bump;		// uncarved part of the newest slab
+	char *end;
+	size_t slabs;		// slabs mapped for this class
+} slab_class;
+
+// Per-thread free list of one size class
+typedef struct slab_cache {
+	slab_obj *free;
+	uint32_t n;
+} slab_cache;
+
+static slab_class classes[SLAB_CLASSES] = {
+	[0 ... SLAB_CLASSES - 1] = { .lock = PTHREAD_MUTEX_INITIALIZER }
+};
+static __thread slab_cache tcache[SLAB_CLASSES];
+static __thread bool tcache_registered;
+static pthread_key_t tcache_key;
+static pthread_once_t tcache_once = PTHREAD_ONCE_INIT;
+static size_t slabs_mapped;
+
+// Returns the size class for size bytes: multiples of 8 up to 64,
+// then powers of two up to SLAB_MAX
+static inline int slab_class_of(size_t size) {
+	int c = 8;
+	size_t s = 128;
+
+	if (size <= 64) return size ? (size - 1) / 8 : 0;
+	while (s < size) {
+		s *= 2;
+		c++;
+	}
+	return c;
+}
+
+// Returns the object size of class c
+static inline size_t slab_class_size(int c) {
+	return c < 8 ? (size_t) (c + 1) * 8 : (size_t) 128 << (c - 8);
+}
+
+// Hands up to n objects of the thread cache back to class c
+static void slab_flush(int c, uint32_t n) {
+	slab_cache *tc = &tcache[c];
+	slab_obj *head = tc->free, *tail = head;
+	uint32_t moved = 1;
+
+	if (!head || !n) return;
+	while (moved < n && tail->next) {
+		tail = tail->next;
+		moved++;
+	}
+	tc->free = tail->next;
+	tc->n -= moved;
+
+	pthread_mutex_lock(&classes[c].lock);
+	tail->next = classes[c].free;
+	classes[c].free = head;
+	pthread_mutex_unlock(&classes[c].lock);
+}
+
+// Returns every cached object of an exiting thread to the classes
+static void slab_thread_exit(void *arg) {
+	int c;
+	for (c = 0; c < SLAB_CLASSES; c++) slab_flush(c, UINT32_MAX);
+}
+
+static void slab_make_key(void) {
+	pthread_key_create(&tcache_key, slab_thread_exit);
+}
+
+// Fills the thread cache of class c with up to SLAB_BATCH objects
+static void slab_refill(int c) {
+	slab_class *sc = &classes[c];
+	slab_cache *tc = &tcache[c];
+	size_t size = slab_class_size(c);
+
+	if (!tcache_registered) {
+		pthread_once(&tcache_once, slab_make_key);
+		pthread_setspecific(tcache_key, tcache);
+		tcache_registered = true;
+	}
+
+	pthread_mutex_lock(&sc->lock);
+	while (tc->n < SLAB_BATCH) {
+		slab_obj *o = sc->free;
+		if (o) {
+			sc->free = o->next;
+		} else {
+			if (sc->bump + size > sc->end) {
+				sc->bump = mmap(NULL, SLAB_BYTES, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (sc->bump == MAP_FAILED) exit(1);
+				sc->end = sc->bump + SLAB_BYTES;
+				sc->slabs++;
+				__atomic_add_fetch(&slabs_mapped, 1, __ATOMIC_RELAXED);
+			}
+			o = (slab_obj *) sc->bump;
+			sc->bump += size;
+		}
+		o->next = tc->free;
+		tc->free = o;
+		tc->n++;
+	}
+	pthread_mutex_unlock(&sc->lock);
+}
+
+// Returns size bytes of storage
+void *slab_alloc(size_t size) {
+	int c;
+	slab_obj *o;
+
+	if (size > SLAB_MAX) {
+		void *p = malloc(size);
+		if (!p) exit(1);
+		return p;
+	}
+	c = slab_class_of(size);
+	if (!tcache[c].free) slab_refill(c);
+	o = tcache[c].free;
+	tcache[c].free = o->next;
+	tcache[c].n--;
+	return o;
+}
+
+// Releases p, which was allocated with the same size
+void slab_free(void *p, size_t size) {
+	int c;
+	slab_obj *o = p;
+
+	if (!p) return;
+	if (size > SLAB_MAX) {
+		free(p);
+		return;
+	}
+	c = slab_class_of(size);
+	o->next = tcache[c].free;
+	tcache[c].free = o;
+	if (++tcache[c].n >= 2 * SLAB_BATCH) slab_flush(c, SLAB_BATCH);
+}
+
+// Returns the number of slabs mapped across all classes
+size_t slab_count(void) {
+	return __atomic_load_n(&slabs_mapped, __ATOMIC_RELAXED);
+}
+
+
+/*
+	Open-addressing index API
+
+	Slots are grouped GROUP_WIDTH at a time, with one control byte
+	per slot: CTRL_EMPTY, CTRL_DELETED, or the low 7 bits of the key's
+	hash. A probe loads a whole group of control bytes and compares
+	them in one go, so keys are only touched on a likely match.
+	Growing allocates the new array up front and moves the old one
+	over a few groups per insert, so no single insert pays for a
+	full rehash. Lookups take no lock: arrays are published through
+	pointers and retired through ebr_retire, and a lookup that misses
+	while entries are moving between arrays tries again.
+*/
+
+// Returns a bitmask of the slots in group g whose control byte is h
+static inline uint32_t group_match(const int8_t *g, int8_t h) {
+#ifdef __SSE2__
+	__m128i ctrl = _mm_load_si128((const __m128i *) g);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h)));
+#else
+	uint32_t mask = 0;
+	int i;
+	for (i = 0; i < GROUP_WIDTH; i++) if (g[i] == h) mask |= 1u << i;
+	return mask;
+#endif
+}
+
+// Returns a bitmask of the slots in group g that are empty or deleted
+static inline uint32_t group_free(const int8_t *g) {
+#ifdef __SSE2__
+	return _mm_movemask_epi8(_mm_load_si128((const __m128i *) g));
+#else
+	uint32_t mask = 0;
+	int i;
+	for (i = 0; i < GROUP_WIDTH; i++) if (g[i] < 0) mask |= 1u << i;
+	return mask;
+#endif
+}
+
+// Returns a new empty array of cap slots
+static id_array *idt_alloc(size_t cap) {
+	id_array *a = slab_alloc(sizeof(id_array));
+
+	// cap is a power of two of at least GROUP_WIDTH, so the class keeps
+	// the control bytes group-aligned
+	a->ctrl = slab_alloc(cap);
+	a->slots = slab_alloc(cap * sizeof(id_slot));
+	memset(a->ctrl, CTRL_EMPTY, cap);
+	a->cap = cap;
+	a->used = 0;
+	a->tombs = 0;
+	return a;
+}
+
+// Retires an array that readers may still be probing
+static void idt_release(id_array *a) {
+	ebr_retire(a->ctrl, a->cap);
+	ebr_retire(a->slots, a->cap * sizeof(id_slot));
+	ebr_retire(a, sizeof(id_array));
+}
+
+// Returns index of key in a, or -1 if it is not there. Safe against a
+// concurrent writer: a slot's value is written before its key and its
+// key before its control byte, so a matching key has a matching value.
+static ssize_t idt_probe(const id_array *a, uint64_t key, uint64_t hash) {
+	size_t mask = a->cap / GROUP_WIDTH - 1;
+	size_t g = (hash >> 7) & mask;
+	int8_t h2 = hash & 0x7f;
+	size_t step;
+
+	for (step = 1; step <= mask + 1; step++) {
+		const int8_t *ctrl = a->ctrl + g * GROUP_WIDTH;
+		uint32_t match = group_match(ctrl, h2);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		while (match) {
+			int i = __builtin_ctz(match);
+			if (__atomic_load_n(&a->slots[g * GROUP_WIDTH + i].key,
+				__ATOMIC_ACQUIRE) == key)
+				return g * GROUP_WIDTH + i;
+			match &= match - 1;
+		}
+		if (group_match(ctrl, CTRL_EMPTY)) return -1;
+		g = (g + step) & mask;
+	}
+	return -1;
+}
+
+// Places key in the first free slot of its probe sequence, assumes absent
+static void idt_place(id_array *a, uint64_t key, void *val, uint64_t hash) {
+	size_t mask = a->cap / GROUP_WIDTH - 1;
+	size_t g = (hash >> 7) & mask;
+	size_t step;
+
+	for (step = 1; ; step++) {
+		uint32_t free_slots = group_free(a->ctrl + g * GROUP_WIDTH);
+		if (free_slots) {
+			size_t i = g * GROUP_WIDTH + __builtin_ctz(free_slots);
+			if (a->ctrl[i] == CTRL_DELETED) a->tombs--;
+			__atomic_store_n(&a->slots[i].val, val, __ATOMIC_RELAXED);
+			__atomic_store_n(&a->slots[i].key, key, __ATOMIC_RELEASE);
+			__atomic_store_n(&a->ctrl[i], (int8_t) (hash & 0x7f), __ATOMIC_RELEASE);
+			a->used++;
+			return;
+		}
+		g = (g + step) & mask;
+	}
+}
+
+// Moves up to n groups of the old array into the current one. Entries
+// briefly live in both arrays, and readers retry misses that overlap
+// a move, so a lookup never misses a key that is present throughout.
+static void idt_migrate(id_table *t, size_t n) {
+	id_array *old = t->old;
+	size_t groups = old->cap / GROUP_WIDTH;
+	size_t i;
+
+	__atomic_store_n(&t->seq, t->seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	while (n-- && t->drain < groups) {
+		for (i = t->drain * GROUP_WIDTH; i < (t->drain + 1) * GROUP_WIDTH; i++) {
+			if (old->ctrl[i] < 0) continue;
+			idt_place(t->cur, old->slots[i].key, old->slots[i].val,
+				hash_vertex(old->slots[i].key));
+			__atomic_store_n(&old->ctrl[i], CTRL_DELETED, __ATOMIC_RELEASE);
+		}
+		t->drain++;
+	}
+	if (t->drain == groups) {
+		__atomic_store_n(&t->old, NULL, __ATOMIC_RELEASE);
+		idt_release(old);
+	}
+	__atomic_store_n(&t->seq, t->seq + 1, __ATOMIC_RELEASE);
+}
+
+// Starts moving everything into a fresh array, doubled if mostly live
+static void idt_grow(id_table *t) {
+	size_t cap = t->cur->cap;
+
+	// finish any migration still in flight before starting another
+	if (t->old) idt_migrate(t, SIZE_MAX);
+	if (t->cur->used * 2 >= cap) cap *= 2;
+
+	__atomic_store_n(&t->seq, t->seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	t->drain = 0;
+	__atomic_store_n(&t->old, t->cur, __ATOMIC_RELEASE);
+	__atomic_store_n(&t->cur, idt_alloc(cap), __ATOMIC_RELEASE);
+	__atomic_store_n(&t->seq, t->seq + 1, __ATOMIC_RELEASE);
+}
+
+// Initializes an empty table; cap is rounded up to a power of two
+void idt_init(id_table *t, size_t cap) {
+	size_t c = GROUP_WIDTH;
+	while (c < cap) c *= 2;
+	t->cur = idt_alloc(c);
+	t->old = NULL;
+	t->drain = 0;
+	t->size = 0;
+	t->seq = 0;
+}
+
+// Returns the value stored for key, or NULL if it doesn't exist.
+// Needs no lock, but the caller must be inside ebr_enter/ebr_exit.
+void *idt_find(id_table *t, uint64_t key) {
+	uint64_t hash = hash_vertex(key);
+
+	for (;;) {
+		uint32_t seq = __atomic_load_n(&t->seq, __ATOMIC_ACQUIRE);
+		id_array *cur = __atomic_load_n(&t->cur, __ATOMIC_ACQUIRE);
+		id_array *old = __atomic_load_n(&t->old, __ATOMIC_ACQUIRE);
+		ssize_t i;
+
+		if (seq & 1) continue;
+		if ((i = idt_probe(cur, key, hash)) >= 0)
+			return __atomic_load_n(&cur->slots[i].val, __ATOMIC_RELAXED);
+		if (old && (i = idt_probe(old, key, hash)) >= 0)
+			return __atomic_load_n(&old->slots[i].val, __ATOMIC_RELAXED);
+		// a miss only counts if no entries moved while we looked
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&t->seq, __ATOMIC_RELAXED) == seq) return NULL;
+	}
+}
+
+// Adds key -> val, returns false if key existed. Writers must be
+// serialized by the caller.
+bool idt_insert(id_table *t, uint64_t key, void *val) {
+	uint64_t hash = hash_vertex(key);
+
+	if (idt_find(t, key)) return false;
+	if (t->old) idt_migrate(t, MIGRATE_GROUPS);
+	if ((t->cur->used + t->cur->tombs + 1) * 8 > t->cur->cap * 7) idt_grow(t);
+
+	idt_place(t->cur, key, val, hash);
+	t->size++;
+	return true;
+}
+
+// Removes key, returns its value or NULL if it didn't exist
+void *idt_erase(id_table *t, uint64_t key) {
+	uint64_t hash = hash_vertex(key);
+	id_array *a = t->cur;
+	ssize_t i = idt_probe(a, key, hash);
+	void *val;
+
+	if (i < 0 && t->old) {
+		a = t->old;
+		i = idt_probe(a, key, hash);
+	}
+	if (i < 0) return NULL;
+
+	// a group that still has an empty slot ends every probe through it,
+	// so the slot can go straight back to empty
+	val = a->slots[i].val;
+	if (group_match(a->ctrl + (i & ~(size_t) (GROUP_WIDTH - 1)), CTRL_EMPTY)) {
+		__atomic_store_n(&a->ctrl[i], CTRL_EMPTY, __ATOMIC_RELEASE);
+	} else {
+		__atomic_store_n(&a->ctrl[i], CTRL_DELETED, __ATOMIC_RELEASE);
+		a->tombs++;
+	}
+	a->used--;
+	t->size--;
+	return val;
+}
+
+// Calls fn on every entry of a. May race a writer, inside ebr_enter.
+static void idt_scan_array(id_array *a, void (*fn)(uint64_t, void *, void *),
+	void *arg) {
+	size_t i;
+
+	for (i = 0; i < a->cap; i++) {
+		if (__atomic_load_n(&a->ctrl[i], __ATOMIC_ACQUIRE) < 0) continue;
+		fn(__atomic_load_n(&a->slots[i].key, __ATOMIC_ACQUIRE),
+			__atomic_load_n(&a->slots[i].val, __ATOMIC_RELAXED), arg);
+	}
+}
+
+// Calls fn(key, val, arg) on every entry without locking. Alongside a
+// writer, an entry moving between arrays may be seen twice or missed;
+// callers that care compare map.version before and after.
+void idt_scan(id_table *t, void (*fn)(uint64_t, void *, void *), void *arg) {
+	id_array *old = __atomic_load_n(&t->old, __ATOMIC_ACQUIRE);
+
+	idt_scan_array(__atomic_load_n(&t->cur, __ATOMIC_ACQUIRE), fn, arg);
+	if (old) idt_scan_array(old, fn, arg);
+}
+
+// Advances *pos to the next live entry, returns false when done
+bool idt_next(id_table *t, size_t *pos, uint64_t *key, void **val) {
+	size_t old_cap = t->old ? t->old->cap : 0;
+
+	while (*pos < t->cur->cap + old_cap) {
+		id_array *a = *pos < t->cur->cap ? t->cur : t->old;
+		size_t i = *pos < t->cur->cap ? *pos : *pos - t->cur->cap;
+		(*pos)++;
+		if (a->ctrl[i] < 0) continue;
+		if (key) *key = a->slots[i].key;
+		if (val) *val = a->slots[i].val;
+		return true;
+	}
+	return false;
+}
+
 
 /*
 	Hashtable API
+
+	The map is split into MAP_STRIPES stripes by vertex id, each with
+	its own index and reader-writer lock. Writers of a vertex's record
+	or neighbors hold its stripe's lock, which callers take around each
+	request with lock_node or lock_edge; the store functions themselves
+	don't lock. get_node, get_edge and get_neighbors need no lock at
+	all, see the sequence locks below.
+
+	Each vertex also gets a dense 32-bit local index when it is added,
+	and neighbor lists, CSR snapshots and search state are keyed by it
+	rather than by id. map.by_idx maps an index back to its vertex: a
+	directory of fixed chunks, allocated as indices reach them and
+	never moved or freed, so it is read without a lock. Ids go in and
+	out only where a request or an RPC is answered.
+
+	An edge across partitions is stored on both, so each keeps a ghost
+	of the other's endpoint: a record holding just the id and the local
+	vertices it's adjacent to. Ghosts live in their stripe's own ghost
+	table, not in the index, and stay out of nsize, the existence set
+	and the filter. When remove_edge takes a ghost's last edge, the
+	ghost leaves its table, its slot in map.by_idx goes back to NULL,
+	and the record is retired. The neighbor lists that held the index
+	were written first, so a reader that still finds it fails
+	validation and retries. The index itself goes on a queue of spare
+	indices, which add_vertex takes from before handing out a new one,
+	but only two epochs later, as ebr_retire does with memory: by then
+	no search or snapshot build that picked it up is still running.
 */
 
 // global hashtable for vertices
 vertex_map map;
 
+// degree above which a vertex's neighbors move into a hash set
+uint32_t hub_threshold = ADJ_HUB_DEFAULT;
+
+// whether neighbor lists are stored compressed
+bool adj_compress = false;
+
+extern int CHAIN_NUM;
+
+// Local indices of reclaimed ghosts, oldest first, with the epoch each
+// was given up in
+typedef struct spare_idx {
+	uint32_t idx;
+	uint64_t epoch;
+} spare_idx;
+
+static struct {
+	pthread_mutex_t lock;
+	spare_idx *q;
+	size_t head;		// oldest
+	size_t n;		// waiting; read without the lock to skip it
+	size_t cap;		// power of two
+} spare = { PTHREAD_MUTEX_INITIALIZER };
+
+// Returns true if this partition owns vertex id, false for a ghost
+static inline bool owned(uint64_t id) {
+	return id % PARTITIONS + 1 == CHAIN_NUM;
+}
+
+// Initializes the global vertex map
+void init_map(void) {
+	int i;
+	for (i = 0; i < MAP_STRIPES; i++) {
+		pthread_rwlock_init(&map.stripes[i].lock, NULL);
+		idt_init(&map.stripes[i].index, INIT_CAPACITY);
+		idt_init(&map.stripes[i].ghosts, GROUP_WIDTH);
+	}
+	map.nsize = 0;
+	map.esize = 0;
+	map.ghosts = 0;
+	map.reclaimed = 0;
+	map.reused = 0;
+	spare.head = 0;
+	spare.n = 0;
+	map.hubs = 0;
+	map.promotions = 0;
+	map.demotions = 0;
+	map.version = 0;
+	map.adj_bytes = 0;
+	exist_init();
+	filter_init();
+	rcache_init();
+}
+
+// Calls fn(id, vertex, arg) on every owned vertex without locking; see idt_scan
+void map_scan(void (*fn)(uint64_t, void *, void *), void *arg) {
+	int i;
+
+	ebr_enter();
+	for (i = 0; i < MAP_STRIPES; i++) idt_scan(&map.stripes[i].index, fn, arg);
+	ebr_exit();
+}
+
+// Returns the stripe owning vertex id; uses the top hash bits, which
+// the stripe's own table doesn't probe with
+static inline vertex_stripe *stripe_of(uint64_t id) {
+	return &map.stripes[hash_vertex(id) >> (64 - MAP_STRIPE_BITS)];
+}
+
+// Locks the stripe of vertex id, shared unless write is set
+void lock_node(uint64_t id, bool write) {
+	vertex_stripe *s = stripe_of(id);
+	if (write) pthread_rwlock_wrlock(&s->lock);
+	else pthread_rwlock_rdlock(&s->lock);
+}
+
+// Unlocks the stripe of vertex id
+void unlock_node(uint64_t id) {
+	pthread_rwlock_unlock(&stripe_of(id)->lock);
+}
+
+// Locks the stripes of both endpoints, lowest stripe first so that two
+// edge operations can never wait on each other in a cycle
+void lock_edge(uint64_t a, uint64_t b, bool write) {
+	vertex_stripe *sa = stripe_of(a);
+	vertex_stripe *sb = stripe_of(b);
 
-// Returns hash value
-int hash_vertex(uint64_t id) {
-	return id % SIZE;
+	if (sa > sb) {
+		vertex_stripe *tmp = sa;
+		sa = sb;
+		sb = tmp;
+	}
+	if (write) pthread_rwlock_wrlock(&sa->lock);
+	else pthread_rwlock_rdlock(&sa->lock);
+	if (sa == sb) return;
+	if (write) pthread_rwlock_wrlock(&sb->lock);
+	else pthread_rwlock_rdlock(&sb->lock);
 }
 
-// Returns pointer to vertex id, or NULL if it doesn't exist
+// Unlocks the stripes of both endpoints
+void unlock_edge(uint64_t a, uint64_t b) {
+	vertex_stripe *sa = stripe_of(a);
+	vertex_stripe *sb = stripe_of(b);
+
+	pthread_rwlock_unlock(&sa->lock);
+	if (sa != sb) pthread_rwlock_unlock(&sb->lock);
+}
+
+// Write-locks the stripes of the n ids, each once; lowest first, like
+// lock_edge. A bit per stripe works since there are at most 64.
+uint64_t lock_stripes(const uint64_t *ids, size_t n) {
+	uint64_t taken = 0, left;
+	size_t i;
+
+	for (i = 0; i < n; i++) taken |= 1ULL << (stripe_of(ids[i]) - map.stripes);
+	for (left = taken; left; left &= left - 1) {
+		pthread_rwlock_wrlock(&map.stripes[__builtin_ctzll(left)].lock);
+	}
+	return taken;
+}
+
+// Unlocks the stripes lock_stripes took
+void unlock_stripes(uint64_t taken) {
+	for (; taken; taken &= taken - 1) {
+		pthread_rwlock_unlock(&map.stripes[__builtin_ctzll(taken)].lock);
+	}
+}
+
+// Returns hash value (murmur3 finalizer, so sequential ids spread out)
+uint64_t hash_vertex(uint64_t id) {
+	id ^= id >> 33;
+	id *= 0xff51afd7ed558ccdULL;
+	id ^= id >> 33;
+	id *= 0xc4ceb9fe1a85ec53ULL;
+	id ^= id >> 33;
+	return id;
+}
+
+// Returns pointer to vertex id, or NULL if it doesn't exist; a ghost
+// for ids of other partitions
 vertex *ret_vertex(uint64_t id) {
-	int hash = hash_vertex(id);
-	vertex** table = map.table;
-	vertex* index = table[hash];
-
-	if(index != NULL) {
-		if(index->id == id) return index;
-		while(index->next) {
-			if(index->id == id) return index;
-			index = index->next;
+	vertex_stripe *s = stripe_of(id);
+	return idt_find(owned(id) ? &s->index : &s->ghosts, id);
+}
+
+// Returns the vertex with local index idx, or NULL if there is none yet
+vertex *vertex_at(uint32_t idx) {
+	vertex **chunk = __atomic_load_n(&map.by_idx[idx >> IDX_CHUNK_BITS], __ATOMIC_ACQUIRE);
+
+	if (!chunk) return NULL;
+	return __atomic_load_n(&chunk[idx & ((1 << IDX_CHUNK_BITS) - 1)], __ATOMIC_ACQUIRE);
+}
+
+// Returns the id of the vertex with local index idx, which must exist
+uint64_t id_at(uint32_t idx) {
+	return vertex_at(idx)->id;
+}
+
+// Records v under its local index; writers of different stripes may
+// race to allocate the same chunk
+static void index_vertex(vertex *v) {
+	vertex ***slot = &map.by_idx[v->idx >> IDX_CHUNK_BITS];
+	vertex **chunk = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+
+	if (!chunk) {
+		vertex **fresh = calloc(1 << IDX_CHUNK_BITS, sizeof(vertex *));
+		if (!fresh) exit(1);
+		if (__atomic_compare_exchange_n(slot, &chunk, fresh, false,
+			__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) chunk = fresh;
+		else free(fresh);
+	}
+	__atomic_store_n(&chunk[v->idx & ((1 << IDX_CHUNK_BITS) - 1)], v, __ATOMIC_RELEASE);
+}
+
+// Clears the slot of v's local index; its chunk exists since v was indexed
+static void unindex_vertex(vertex *v) {
+	vertex **chunk = map.by_idx[v->idx >> IDX_CHUNK_BITS];
+
+	__atomic_store_n(&chunk[v->idx & ((1 << IDX_CHUNK_BITS) - 1)], NULL, __ATOMIC_RELEASE);
+}
+
+// Queues the local index of a reclaimed ghost for reuse
+static void idx_release(uint32_t idx) {
+	pthread_mutex_lock(&spare.lock);
+	if (spare.n == spare.cap) {
+		size_t cap = spare.cap ? spare.cap * 2 : 1024, i;
+		spare_idx *q = malloc(cap * sizeof(spare_idx));
+
+		if (!q) exit(1);
+		for (i = 0; i < spare.n; i++) q[i] = spare.q[(spare.head + i) & (spare.cap - 1)];
+		free(spare.q);
+		spare.q = q;
+		spare.head = 0;
+		spare.cap = cap;
+	}
+	spare.q[(spare.head + spare.n) & (spare.cap - 1)] = (spare_idx) { idx, ebr_epoch() };
+	__atomic_store_n(&spare.n, spare.n + 1, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&spare.lock);
+}
+
+// Returns a local index for a new vertex: the oldest spare one if no
+// reader can hold it any more, a new one otherwise
+static uint32_t idx_take(void) {
+	uint32_t idx;
+
+	if (__atomic_load_n(&spare.n, __ATOMIC_RELAXED)) {
+		pthread_mutex_lock(&spare.lock);
+		if (spare.n && spare.q[spare.head].epoch + 2 <= ebr_epoch()) {
+			idx = spare.q[spare.head].idx;
+			spare.head = (spare.head + 1) & (spare.cap - 1);
+			__atomic_store_n(&spare.n, spare.n - 1, __ATOMIC_RELAXED);
+			pthread_mutex_unlock(&spare.lock);
+			__atomic_add_fetch(&map.reused, 1, __ATOMIC_RELAXED);
+			return idx;
 		}
+		pthread_mutex_unlock(&spare.lock);
 	}
-	return NULL;
+	return __atomic_fetch_add(&map.next_idx, 1, __ATOMIC_RELAXED);
 }
 
 // Adds vertex, returns false is vertex existed
 bool add_vertex(uint64_t id) {
 
-	
-
-	int hash = hash_vertex(id);
-	vertex** table = map.table;
-
 	// ensures vertex does not exist
 	if(ret_vertex(id)) return false;
 
-	vertex* new = malloc(sizeof(vertex));
-	if(!new) exit(1); // TODO: free everything
+	vertex* new = slab_alloc(sizeof(vertex));
 	new->id = id;
-	new->next = table[hash];
-	new->head = NULL;
-	new->path = -1;
-	new->visited = 0;
-	table[hash] = new;
-	map.nsize += 1;
-
-
+	new->adj.ids = NULL;
+	new->adj.n = 0;
+	new->adj.cap = 0;
+	new->adj.hub = false;
+	new->adj.packed = NULL;
+	new->seq = 0;
+	new->idx = idx_take();
+	// ADJ_EMPTY marks hub set holes, so the last index is never handed out
+	if (new->idx == ADJ_EMPTY) exit(1);
+	// indexed before it can be found, so any index in a list resolves
+	index_vertex(new);
+	if (!owned(id)) {
+		idt_insert(&stripe_of(id)->ghosts, id, new);
+		__atomic_add_fetch(&map.ghosts, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&map.version, 1, __ATOMIC_RELEASE);
+		return true;
+	}
+	idt_insert(&stripe_of(id)->index, id, new);
+	// after the table, so whatever the set finds can be looked up
+	exist_add(id);
+	// once indexed, since a filter rebuilt meanwhile goes by the index
+	filter_add(id);
+	__atomic_add_fetch(&map.nsize, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&map.version, 1, __ATOMIC_RELEASE);
 
 	return true;
 }
 
-// Check if a vertex is in a graph. 
+// Check if a vertex is in a graph; answered by the existence set for
+// the ids owned here, by the ghost tables for the rest
 bool get_node(uint64_t id) {
-	if (ret_vertex(id) == NULL){
-		return false;
-	}
-	return true;
+	bool found;
+
+	if (owned(id)) return exist_test(id);
+	ebr_enter();
+	found = ret_vertex(id) != NULL;
+	ebr_exit();
+	return found;
 }
 
 // Check if an edge is in a graph 
 bool get_edge(uint64_t a, uint64_t b){
-	vertex *v1 = ret_vertex(a);
-	vertex *v2 = ret_vertex(b);
-	if (LL_contains(&(v1->head), b) && LL_contains(&(v2->head), a)){
-		return true;
+	vertex *v1, *v2, *v;
+	adj_list l1, l2;
+	uint32_t seq;
+	bool found = false;
+
+	// a missing endpoint is turned away without a probe of the table
+	if ((owned(a) && !exist_test(a)) || (owned(b) && !exist_test(b))) return false;
+	ebr_enter();
+	v1 = ret_vertex(a);
+	v2 = ret_vertex(b);
+	if (v1 && v2) {
+		// edges are stored on both endpoints, so search the shorter list
+		adj_snapshot(v1, &l1);
+		adj_snapshot(v2, &l2);
+		v = l1.n <= l2.n ? v1 : v2;
+		do {
+			seq = adj_snapshot(v, &l1);
+			found = adj_contains(&l1, v == v1 ? v2->idx : v1->idx);
+		} while (!read_valid(v, seq));
 	}
-	return false;
+	ebr_exit();
+	return found;
 }
 
 /*
-	Linked-list API
+	Vertex sequence locks
+
+	A vertex's seq is odd while a writer (holding its stripe's write
+	lock) changes its neighbors. Readers take no lock: they copy the
+	list header, read through it, and start over if seq moved. Arrays
+	a writer replaces are retired rather than freed, so a reader
+	holding a stale header still reads valid memory until ebr_exit.
 */
 
-// Inserts n into linked list
-void LL_insert(edge** head, uint64_t n){
-    edge* newnode = malloc(sizeof(edge));
-    newnode->b = n;
-    newnode->next = NULL;
-
-    if(*head==NULL)
-    {
-        *head = newnode;
-    }
-    else
-    {
-        edge* temp; 
-        temp = *head;
-        *head = newnode;
-        newnode->next = temp;
-    }
-}
-
-// Returns true if n is in the linked list
-bool LL_contains(edge** head, uint64_t n) {
-    edge* ptr = *head; 
-    while(ptr) {
-        if(ptr->b == n) return true;
-        ptr = ptr->next;
-    }
-    return false;
-}
-
-// Removes n from linked list
-bool LL_delete(edge** head, uint64_t n)
-{
-    if(*head == NULL) return false;
-    else {
-        edge* tmp = *head;
-        if(tmp->b == n) {
-            tmp = tmp->next;
-            free(*head);
-            *head = tmp;
-            return true;
-        }
-
-        while(tmp->next)
-        {
-            if(tmp->next->b == n) {
-                edge* tmp2 = tmp->next->next;
-                free(tmp->next);
-                tmp->next = tmp2;
-                return true;
-            }
-            tmp = tmp->next;
-        }
-    }
-    return false;
-}
-
-// Adds edge, returns 
-int add_edge(uint64_t a, uint64_t b) {
+// Waits out any writer of v, returns the seq to validate against
+static inline uint32_t read_begin(const vertex *v) {
+	uint32_t seq;
+	while ((seq = __atomic_load_n(&v->seq, __ATOMIC_ACQUIRE)) & 1);
+	return seq;
+}
+
+// Returns true if v hasn't been written since read_begin returned seq
+bool read_valid(const vertex *v, uint32_t seq) {
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&v->seq, __ATOMIC_RELAXED) == seq;
+}
+
+// Marks v as being written
+static inline void write_begin(vertex *v) {
+	__atomic_store_n(&v->seq, v->seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+// Publishes the writes made since write_begin
+static inline void write_end(vertex *v) {
+	__atomic_store_n(&v->seq, v->seq + 1, __ATOMIC_RELEASE);
+}
+
+// Copies a consistent header of v's neighbor list into l and returns
+// the seq it was read at; l's array stays readable until ebr_exit
+uint32_t adj_snapshot(const vertex *v, adj_list *l) {
+	uint32_t seq;
+
+	do {
+		seq = read_begin(v);
+		l->ids = __atomic_load_n(&v->adj.ids, __ATOMIC_RELAXED);
+		l->n = __atomic_load_n(&v->adj.n, __ATOMIC_RELAXED);
+		l->cap = __atomic_load_n(&v->adj.cap, __ATOMIC_RELAXED);
+		l->hub = __atomic_load_n(&v->adj.hub, __ATOMIC_RELAXED);
+		l->packed = __atomic_load_n(&v->adj.packed, __ATOMIC_RELAXED);
+	} while (!read_valid(v, seq));
+	return seq;
+}
+
+/*
+	Adjacency API
+
+	Each vertex keeps its neighbors' local indices in one sorted,
+	growable array of 32-bit entries, half the size ids would take, so
+	membership is a binary search and copying the neighbors out is a
+	single memcpy. Once a vertex has more than hub_threshold neighbors
+	the array becomes a linear-probing hash set instead, and it goes
+	back to a sorted array below half that, so hubs answer membership
+	in O(1) without flapping at the boundary.
+
+	In compressed mode (-z) there are no hubs. Most of a list lives in
+	an immutable adj_packed: blocks of ADJ_BLOCK indices, each starting
+	with its first index in full, followed by varint gaps between the
+	rest. New ids go into the sorted array, which acts as a write
+	buffer and is merged into a fresh adj_packed once it holds more
+	than 1/ADJ_BUF_RATIO of the list. Deleting a packed id merges as
+	well. Membership bisects the block starts and decodes one block.
+*/
+
+// Allocates a neighbor array or packed list, counted in map.adj_bytes
+static void *adj_alloc(size_t size) {
+	__atomic_add_fetch(&map.adj_bytes, size, __ATOMIC_RELAXED);
+	return slab_alloc(size);
+}
+
+// Retires what adj_alloc returned
+static void adj_release(void *p, size_t size) {
+	if (!p) return;
+	__atomic_sub_fetch(&map.adj_bytes, size, __ATOMIC_RELAXED);
+	ebr_retire(p, size);
+}
+
+// Returns the number of entries in l's array: all of them, unless some are packed
+static inline uint32_t adj_buffered(const adj_list *l) {
+	return l->n - (l->packed ? l->packed->n : 0);
+}
+
+// Returns a bitmask with bit i set if ids[i] == n, for i < 4
+static inline int quad_match(const uint32_t *ids, uint32_t n) {
+#ifdef __SSE2__
+	__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) ids),
+		_mm_set1_epi32(n));
+	return _mm_movemask_ps(_mm_castsi128_ps(eq));
+#else
+	return (ids[0] == n) | ((ids[1] == n) << 1) | ((ids[2] == n) << 2) |
+		((ids[3] == n) << 3);
+#endif
+}
+
+// Returns index of the first of the count sorted entries that is >= n
+static uint32_t adj_lower_bound(const uint32_t *ids, uint32_t count, uint32_t n) {
+	uint32_t lo = 0, hi = count;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (ids[mid] < n) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// Moves a sorted list (or write buffer) to an array of cap entries
+static void adj_resize(adj_list *l, uint32_t cap) {
+	uint32_t *ids = adj_alloc(cap * sizeof(uint32_t));
+
+	if (l->ids) memcpy(ids, l->ids, adj_buffered(l) * sizeof(uint32_t));
+	adj_release(l->ids, l->cap * sizeof(uint32_t));
+	l->ids = ids;
+	l->cap = cap;
+}
+
+// Returns true if n is among the count sorted entries
+static bool sorted_contains(const uint32_t *ids, uint32_t count, uint32_t n) {
+	uint32_t lo = 0, hi = count;
+	uint32_t i;
+
+	// narrow down to a short window, then compare four entries at a time
+	while (hi - lo > ADJ_SCAN) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (ids[mid] < n) lo = mid + 1;
+		else if (ids[mid] > n) hi = mid;
+		else return true;
+	}
+	for (i = lo; i + 4 <= hi; i += 4)
+		if (quad_match(ids + i, n)) return true;
+	for (; i < hi; i++)
+		if (ids[i] == n) return true;
+	return false;
+}
+
+// Returns the slot holding n in a hub set, or the empty slot ending its run
+static uint32_t hub_slot(const adj_list *l, uint32_t n) {
+	uint32_t mask = l->cap - 1;
+	uint32_t i = hash_vertex(n) & mask;
+	uint32_t probes = l->cap;
+
+	// the probe bound only matters to a reader racing a writer
+	while (l->ids[i] != n && l->ids[i] != ADJ_EMPTY && --probes)
+		i = (i + 1) & mask;
+	return i;
+}
+
+// Rebuilds l as a hub set of cap slots holding the n entries given
+static void hub_build(adj_list *l, const uint32_t *ids, uint32_t n, uint32_t cap) {
+	uint32_t i;
+
+	l->ids = adj_alloc(cap * sizeof(uint32_t));
+	for (i = 0; i < cap; i++) l->ids[i] = ADJ_EMPTY;
+	l->cap = cap;
+	l->hub = true;
+	for (i = 0; i < n; i++) l->ids[hub_slot(l, ids[i])] = ids[i];
+	l->n = n;
+}
+
+// Turns a sorted list that outgrew hub_threshold into a hub set
+static void hub_promote(adj_list *l) {
+	uint32_t *ids = l->ids;
+	uint32_t old_cap = l->cap;
+	uint32_t cap = l->cap;
+
+	while (cap < l->n * 4) cap *= 2;
+	hub_build(l, ids, l->n, cap);
+	adj_release(ids, old_cap * sizeof(uint32_t));
+	__atomic_add_fetch(&map.hubs, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&map.promotions, 1, __ATOMIC_RELAXED);
+}
+
+static int cmp_id(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+	return (x > y) - (x < y);
+}
+
+static int cmp_idx(const void *a, const void *b) {
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+	return (x > y) - (x < y);
+}
+
+// Turns a hub set that shrank below hub_threshold / 2 back into a sorted list
+static void hub_demote(adj_list *l) {
+	uint32_t cap = ADJ_INIT;
+	uint32_t *ids;
+
+	while (cap < l->n * 2) cap *= 2;
+	ids = adj_alloc(cap * sizeof(uint32_t));
+
+	adj_copy(l, ids);
+	qsort(ids, l->n, sizeof(uint32_t), cmp_idx);
+	adj_release(l->ids, l->cap * sizeof(uint32_t));
+	l->ids = ids;
+	l->cap = cap;
+	l->hub = false;
+	__atomic_sub_fetch(&map.hubs, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&map.demotions, 1, __ATOMIC_RELAXED);
+}
+
+// Returns the bytes v takes as a varint
+static inline uint32_t varint_size(uint32_t v) {
+	uint32_t n = 1;
+	while (v >= 0x80) {
+		v >>= 7;
+		n++;
+	}
+	return n;
+}
+
+// Writes v as a varint, low 7 bits first, returns the byte after it
+static inline uint8_t *varint_put(uint8_t *p, uint32_t v) {
+	while (v >= 0x80) {
+		*p++ = v | 0x80;
+		v >>= 7;
+	}
+	*p++ = v;
+	return p;
+}
+
+#ifdef __SSE2__
+// Stores prev plus the running sums of the first m (8 or 16) bytes
+// of gaps, each under 0x80, into out; returns the last index
+static inline uint32_t gap_run(__m128i gaps, int m, uint32_t prev, uint32_t *out) {
+	__m128i zero = _mm_setzero_si128();
+	__m128i half[2];
+	int h;
+
+	half[0] = _mm_unpacklo_epi8(gaps, zero);
+	half[1] = _mm_unpackhi_epi8(gaps, zero);
+	for (h = 0; h < m / 8; h++, out += 8) {
+		// prefix sum in 16-bit lanes: 8 * 0x7f can't overflow
+		__m128i x = half[h];
+		x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+		x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+		x = _mm_add_epi16(x, _mm_slli_si128(x, 8));
+
+		__m128i base = _mm_set1_epi32(prev);
+		_mm_storeu_si128((__m128i *) out, _mm_add_epi32(base, _mm_unpacklo_epi16(x, zero)));
+		_mm_storeu_si128((__m128i *) (out + 4), _mm_add_epi32(base, _mm_unpackhi_epi16(x, zero)));
+		prev = out[7];
+	}
+	return prev;
+}
+#endif
+
+// Decodes count varint gaps starting at p into out as running sums from
+// prev; end is the end of the stream
+static void varint_decode(const uint8_t *p, const uint8_t *end, uint32_t prev,
+	uint32_t *out, uint32_t count) {
+	uint32_t k = 0;
+
+	while (k < count) {
+		uint32_t v = 0;
+		int shift = 0;
+#ifdef __SSE2__
+		// neighbors of dense indices are mostly one-byte gaps: when the next
+		// 8 or 16 bytes have no continuation bits, add them up together
+		if (count - k >= 8 && end - p >= 16) {
+			__m128i gaps = _mm_loadu_si128((const __m128i *) p);
+			int mask = _mm_movemask_epi8(gaps);
+			if (!(mask & 0xff)) {
+				int m = count - k >= 16 && !mask ? 16 : 8;
+				prev = gap_run(gaps, m, prev, out + k);
+				p += m;
+				k += m;
+				continue;
+			}
+		}
+#endif
+		while (*p & 0x80) {
+			v |= (uint32_t) (*p++ & 0x7f) << shift;
+			shift += 7;
+		}
+		v |= (uint32_t) *p++ << shift;
+		prev += v;
+		out[k++] = prev;
+	}
+}
+
+// Returns the varint stream of p
+static inline const uint8_t *packed_stream(const adj_packed *p) {
+	return (const uint8_t *) (p->blocks + p->nblocks);
+}
+
+// Encodes n sorted entries into a new packed list
+static adj_packed *pack_ids(const uint32_t *ids, uint32_t n) {
+	uint32_t nblocks = (n + ADJ_BLOCK - 1) / ADJ_BLOCK;
+	uint32_t len = 0, i, b;
+	size_t size;
+	adj_packed *p;
+	uint8_t *s, *q;
+
+	for (i = 0; i < n; i++)
+		if (i % ADJ_BLOCK) len += varint_size(ids[i] - ids[i - 1]);
+	size = sizeof(adj_packed) + nblocks * sizeof(adj_block) + len;
+	p = adj_alloc(size);
+	p->n = n;
+	p->nblocks = nblocks;
+	p->len = len;
+	p->size = size;
+	s = q = (uint8_t *) (p->blocks + nblocks);
+	for (b = 0; b < nblocks; b++) {
+		uint32_t lo = b * ADJ_BLOCK;
+		uint32_t hi = n - lo > ADJ_BLOCK ? lo + ADJ_BLOCK : n;
+		p->blocks[b].first = ids[lo];
+		p->blocks[b].off = q - s;
+		p->blocks[b].n = hi - lo;
+		for (i = lo + 1; i < hi; i++) q = varint_put(q, ids[i] - ids[i - 1]);
+	}
+	return p;
+}
+
+// Decodes block b of p into out, returns its number of entries
+static uint32_t unpack_block(const adj_packed *p, uint32_t b, uint32_t *out) {
+	const adj_block *blk = &p->blocks[b];
+	const uint8_t *s = packed_stream(p);
+
+	out[0] = blk->first;
+	varint_decode(s + blk->off, s + p->len, blk->first, out + 1, blk->n - 1);
+	return blk->n;
+}
+
+// Decodes all of p into out, which must hold p->n entries
+static void unpack_ids(const adj_packed *p, uint32_t *out) {
+	uint32_t b;
+	for (b = 0; b < p->nblocks; b++) out += unpack_block(p, b, out);
+}
+
+// Returns true if p holds n
+static bool packed_contains(const adj_packed *p, uint32_t n) {
+	uint32_t ids[ADJ_BLOCK];
+	uint32_t lo = 0, hi, count;
+
+	if (!p) return false;
+	// find the last block starting at or below n
+	hi = p->nblocks;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (p->blocks[mid].first <= n) lo = mid + 1;
+		else hi = mid;
+	}
+	if (!lo) return false;
+	count = unpack_block(p, lo - 1, ids);
+	return sorted_contains(ids, count, n);
+}
+
+// Merges the an sorted entries in out with the bn in b, from the back,
+// so out must have room for both
+static void merge_back(uint32_t *out, uint32_t an, const uint32_t *b, uint32_t bn) {
+	int64_t i = (int64_t) an - 1, j = (int64_t) bn - 1, k = (int64_t) an + bn - 1;
+	while (j >= 0) out[k--] = i >= 0 && out[i] > b[j] ? out[i--] : b[j--];
+}
+
+// Merges l's write buffer into a new packed list, leaving out drop
+// (ADJ_EMPTY for none), and gives the buffer back
+static void packed_merge(adj_list *l, uint32_t drop) {
+	adj_packed *old = l->packed;
+	uint32_t pn = old ? old->n : 0, bn = adj_buffered(l);
+	uint32_t *ids = malloc((pn + bn + 1) * sizeof(uint32_t));
+	uint32_t i, k;
+
+	if (!ids) exit(1);
+	if (old) unpack_ids(old, ids);
+	merge_back(ids, pn, l->ids, bn);
+	for (i = 0, k = 0; i < pn + bn; i++)
+		if (ids[i] != drop) ids[k++] = ids[i];
+
+	l->packed = k ? pack_ids(ids, k) : NULL;
+	l->n = k;
+	adj_release(old, old ? old->size : 0);
+	adj_release(l->ids, l->cap * sizeof(uint32_t));
+	l->ids = NULL;
+	l->cap = 0;
+	free(ids);
+}
+
+// Compressed mode adj_insert
+static bool packed_insert(adj_list *l, uint32_t n) {
+	uint32_t bn = adj_buffered(l);
+	uint32_t i = adj_lower_bound(l->ids, bn, n);
+
+	if (i < bn && l->ids[i] == n) return false;
+	if (packed_contains(l->packed, n)) return false;
+	if (bn == l->cap) adj_resize(l, l->cap ? l->cap * 2 : ADJ_INIT);
+	memmove(l->ids + i + 1, l->ids + i, (bn - i) * sizeof(uint32_t));
+	l->ids[i] = n;
+	l->n++;
+	bn++;
+	if (bn >= ADJ_BUF_MIN && bn * ADJ_BUF_RATIO > l->n) packed_merge(l, ADJ_EMPTY);
+	return true;
+}
+
+// Compressed mode adj_delete
+static bool packed_delete(adj_list *l, uint32_t n) {
+	uint32_t bn = adj_buffered(l);
+	uint32_t i = adj_lower_bound(l->ids, bn, n);
 
-	vertex** table = map.table;
+	if (i < bn && l->ids[i] == n) {
+		memmove(l->ids + i, l->ids + i + 1, (bn - i - 1) * sizeof(uint32_t));
+		l->n--;
+		return true;
+	}
+	if (!packed_contains(l->packed, n)) return false;
+	packed_merge(l, n);
+	return true;
+}
+
+// Returns true if local index n is in the adjacency list
+bool adj_contains(const adj_list *l, uint32_t n) {
+	if (l->hub) return l->ids[hub_slot(l, n)] == n;
+	if (packed_contains(l->packed, n)) return true;
+	return sorted_contains(l->ids, adj_buffered(l), n);
+}
+
+// Inserts n, returns false if it was there
+bool adj_insert(adj_list *l, uint32_t n) {
+	uint32_t i;
+
+	if (adj_compress) return packed_insert(l, n);
+	if (l->hub) {
+		i = hub_slot(l, n);
+		if (l->ids[i] == n) return false;
+		l->ids[i] = n;
+		l->n++;
+		// keep the set at most half full
+		if (l->n * 2 > l->cap) {
+			uint32_t *ids = l->ids;
+			uint32_t cap = l->cap;
+			uint32_t j, k = 0;
+			for (j = 0; j < cap; j++) if (ids[j] != ADJ_EMPTY) ids[k++] = ids[j];
+			hub_build(l, ids, k, cap * 2);
+			adj_release(ids, cap * sizeof(uint32_t));
+		}
+		return true;
+	}
+
+	i = adj_lower_bound(l->ids, l->n, n);
+	if (i < l->n && l->ids[i] == n) return false;
+	if (l->n == l->cap) adj_resize(l, l->cap ? l->cap * 2 : ADJ_INIT);
+	memmove(l->ids + i + 1, l->ids + i, (l->n - i) * sizeof(uint32_t));
+	l->ids[i] = n;
+	l->n++;
+	if (l->n > hub_threshold) hub_promote(l);
+	return true;
+}
 
-	vertex* v1 = table[hash_vertex(a)];
-	vertex* v2 = table[hash_vertex(b)];
+// Removes n from the list, returns false if it wasn't there
+bool adj_delete(adj_list *l, uint32_t n) {
+	uint32_t i;
 
-	// find vertex a
-	while(v1) {
-		if (v1->id == a) break;
-		v1 = v1->next;
+	if (adj_compress) return packed_delete(l, n);
+	if (l->hub) {
+		uint32_t mask = l->cap - 1;
+		uint32_t j;
+
+		i = hub_slot(l, n);
+		if (l->ids[i] != n) return false;
+		// backward-shift the rest of the run so lookups never need tombstones
+		for (j = (i + 1) & mask; l->ids[j] != ADJ_EMPTY; j = (j + 1) & mask) {
+			uint32_t home = hash_vertex(l->ids[j]) & mask;
+			if (((j - home) & mask) >= ((j - i) & mask)) {
+				l->ids[i] = l->ids[j];
+				i = j;
+			}
+		}
+		l->ids[i] = ADJ_EMPTY;
+		l->n--;
+		if (l->n < hub_threshold / 2) hub_demote(l);
+		return true;
+	}
+
+	i = adj_lower_bound(l->ids, l->n, n);
+	if (i == l->n || l->ids[i] != n) return false;
+	memmove(l->ids + i, l->ids + i + 1, (l->n - i - 1) * sizeof(uint32_t));
+	l->n--;
+	// give memory back once the list is mostly empty
+	if (l->cap > ADJ_INIT && l->n * 4 <= l->cap) adj_resize(l, l->cap / 2);
+	return true;
+}
+
+// Copies the neighbors' local indices into out, which must hold l->n
+void adj_copy(const adj_list *l, uint32_t *out) {
+	uint32_t i, k;
+
+	if (l->packed) {
+		unpack_ids(l->packed, out);
+		merge_back(out, l->packed->n, l->ids, adj_buffered(l));
+		return;
 	}
-	// find vertex b
-	while(v2) {
-		if (v2->id == b) break;
-		v2 = v2->next;
+	if (!l->hub) {
+		if (l->n) memcpy(out, l->ids, l->n * sizeof(uint32_t));
+		return;
 	}
-	// code 400
-	if(!v1 || !v2 || a == b){
+	// stop at n so a reader racing a writer can't overrun out
+	for (i = 0, k = 0; i < l->cap && k < l->n; i++)
+		if (l->ids[i] != ADJ_EMPTY) out[k++] = l->ids[i];
+}
+
+// Copies the neighbors' ids into out, which must hold l->n, in list
+// order. The indices are copied into the back half of out and widened
+// front to back: id i overwrites only indices up to i, which have been
+// read by then.
+void adj_ids(const adj_list *l, uint64_t *out) {
+	uint32_t *idx = (uint32_t *) out + l->n;
+	uint32_t i;
+
+	adj_copy(l, idx);
+	for (i = 0; i < l->n; i++) {
+		vertex *v = vertex_at(idx[i]);
+		// only a reader racing a writer can see garbage; it retries
+		out[i] = v ? v->id : 0;
+	}
+}
+
+// Sifts heap[i] down a max-heap of n ids
+static void heap_down(uint64_t *heap, uint32_t n, uint32_t i) {
+	for (;;) {
+		uint32_t c = 2 * i + 1, top = i;
+		uint64_t tmp;
+		if (c < n && heap[c] > heap[top]) top = c;
+		if (c + 1 < n && heap[c + 1] > heap[top]) top = c + 1;
+		if (top == i) return;
+		tmp = heap[i];
+		heap[i] = heap[top];
+		heap[top] = tmp;
+		i = top;
+	}
+}
+
+// Offers id to the max-heap of *k ids that keeps the max smallest
+static inline void heap_offer(uint64_t *heap, uint32_t *k, uint32_t max, uint64_t id) {
+	uint32_t j;
+
+	if (*k < max) {
+		// sift up
+		for (j = (*k)++; j && heap[(j - 1) / 2] < id; j = (j - 1) / 2) heap[j] = heap[(j - 1) / 2];
+		heap[j] = id;
+	} else if (*k && id < heap[0]) {
+		heap[0] = id;
+		heap_down(heap, *k, 0);
+	}
+}
+
+// Sorts a max-heap of k ids in place, ascending
+static void heap_sort(uint64_t *heap, uint32_t k) {
+	uint32_t i;
+
+	for (i = k; i > 1; i--) {
+		uint64_t top = heap[0];
+		heap[0] = heap[i - 1];
+		heap[i - 1] = top;
+		heap_down(heap, i - 1, 0);
+	}
+}
+
+// Adds edge, returns 400, 204 or 200
+int add_edge(uint64_t a, uint64_t b) {
+
+	vertex *v1, *v2;
+
+	// code 400; the existence set answers for missing endpoints
+	if(a == b || (owned(a) && !exist_test(a)) || (owned(b) && !exist_test(b))){
 
 		 return 400;
 	}
-	if(LL_contains(&(v1->head), b)) {
+	v1 = ret_vertex(a);
+	v2 = ret_vertex(b);
+	// a ghost that was never added
+	if (!v1 || !v2) return 400;
+	if(adj_contains(&(v1->adj), v2->idx)) {
 
 		return 204;
 	}
-	LL_insert(&(v1->head), b);
-	LL_insert(&(v2->head), a);
-	map.esize += 1;
+	write_begin(v1);
+	adj_insert(&(v1->adj), v2->idx);
+	write_end(v1);
+	write_begin(v2);
+	adj_insert(&(v2->adj), v1->idx);
+	write_end(v2);
+	__atomic_add_fetch(&map.esize, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&map.version, 1, __ATOMIC_RELEASE);
 	return 200;
 }
 
+// Adds an edge with an endpoint owned by another partition, which is
+// kept here as a ghost for as long as some edge needs it: added first,
+// and dropped again if the edge isn't added
+int add_cross_edge(uint64_t a, uint64_t b) {
+	uint64_t far = owned(a) ? b : a;
+	int code;
+
+	if (owned(a) && owned(b)) return add_edge(a, b);
+	add_vertex(far);
+	code = add_edge(a, b);
+	if (code != 200) reclaim_ghost(far);
+	return code;
+}
+
 // Removes edge, returns false if it didn't exist
 bool remove_edge(uint64_t a, uint64_t b) {
-	vertex** table = map.table;
-	
-	vertex* v1 = table[hash_vertex(a)];
-	vertex* v2 = table[hash_vertex(b)];
 
-	// find vertex a
-	while(v1) {
-		if (v1->id == a) break;
-		v1 = v1->next;
-	}
-	// find vertex b
-	while(v2) {
-		if (v2->id == b) break;
-		v2 = v2->next;
-	}
+	vertex* v1 = ret_vertex(a);
+	vertex* v2 = ret_vertex(b);
 
 	// can't remove edge
-	if(!v1 || !v2) {
+	if(!v1 || !v2 || !adj_contains(&(v1->adj), v2->idx)) {
 
 		return false;
 	}
-	map.esize -= 1;
-	return LL_delete(&(v1->head), b) && LL_delete(&(v2->head), a);
+	write_begin(v1);
+	adj_delete(&(v1->adj), v2->idx);
+	write_end(v1);
+	write_begin(v2);
+	adj_delete(&(v2->adj), v1->idx);
+	write_end(v2);
+	__atomic_sub_fetch(&map.esize, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&map.version, 1, __ATOMIC_RELEASE);
+	reclaim_ghost(a);
+	reclaim_ghost(b);
+	return true;
+}
+
+// Ghosts that emptied while a bulk load was between its rounds; they
+// are reclaimed once no load is, see load_pin
+static struct {
+	pthread_mutex_t lock;
+	uint32_t loads;		// bulk loads between their rounds
+	uint64_t *ids;
+	size_t n;
+	size_t cap;
+} pinned = { PTHREAD_MUTEX_INITIALIZER };
+
+// Drops ghost id if its list is empty: out of its table, out of the
+// directory, then retired with whatever its list still holds. While a
+// bulk load runs it is only noted, and dropped after.
+void reclaim_ghost(uint64_t id) {
+	vertex *v;
+
+	if (owned(id) || !(v = ret_vertex(id)) || v->adj.n) return;
+	pthread_mutex_lock(&pinned.lock);
+	if (pinned.loads) {
+		if (pinned.n == pinned.cap) {
+			pinned.cap = pinned.cap ? pinned.cap * 2 : 64;
+			pinned.ids = realloc(pinned.ids, pinned.cap * sizeof(uint64_t));
+			if (!pinned.ids) exit(1);
+		}
+		pinned.ids[pinned.n++] = id;
+		pthread_mutex_unlock(&pinned.lock);
+		return;
+	}
+	pthread_mutex_unlock(&pinned.lock);
+	idt_erase(&stripe_of(id)->ghosts, id);
+	unindex_vertex(v);
+	idx_release(v->idx);
+	if (v->adj.hub) __atomic_sub_fetch(&map.hubs, 1, __ATOMIC_RELAXED);
+	adj_release(v->adj.packed, v->adj.packed ? v->adj.packed->size : 0);
+	adj_release(v->adj.ids, v->adj.cap * sizeof(uint32_t));
+	ebr_retire(v, sizeof(vertex));
+	__atomic_sub_fetch(&map.ghosts, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&map.reclaimed, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&map.version, 1, __ATOMIC_RELEASE);
+}
+
+/*
+	Bulk loading
+
+	load_edges takes a whole batch of edges at once. Both halves of
+	every edge are bucketed by the stripe of the vertex that stores
+	them. A first round of pool tasks, one per stripe, adds the
+	vertices that are missing, so that every endpoint has a local
+	index; in a second, each stripe turns its halves' other endpoints
+	into local indices, sorts them, and merges each vertex's new
+	neighbors into its list in a single pass under one write lock,
+	rather than inserting them one at a time.
+	The two halves of an edge are written under different locks, so
+	a reader can briefly see one without the other; this is meant for
+	ingesting a graph, not for racing removals.
+
+	Between the rounds no lock is held, and the second one looks up
+	endpoints of other stripes without theirs. A ghost the first
+	round found or added could meanwhile lose its last edge to a
+	remove_edge and be reclaimed, so ghosts are pinned from before
+	the first round to after the second: reclaim_ghost only notes
+	the ones that empty, and the last load to finish reclaims them.
+*/
+
+// Keeps ghosts from being reclaimed until load_unpin
+static void load_pin(void) {
+	pthread_mutex_lock(&pinned.lock);
+	pinned.loads++;
+	pthread_mutex_unlock(&pinned.lock);
+}
+
+// Ends a load_pin; the last one reclaims the ghosts that emptied meanwhile
+static void load_unpin(void) {
+	uint64_t *ids = NULL;
+	size_t n = 0, i;
+
+	pthread_mutex_lock(&pinned.lock);
+	if (!--pinned.loads) {
+		ids = pinned.ids;
+		n = pinned.n;
+		pinned.ids = NULL;
+		pinned.n = pinned.cap = 0;
+	}
+	pthread_mutex_unlock(&pinned.lock);
+	for (i = 0; i < n; i++) {
+		lock_node(ids[i], true);
+		reclaim_ghost(ids[i]);
+		unlock_node(ids[i]);
+	}
+	free(ids);
+}
+
+// One endpoint's half of an edge: dst goes into src's list; dst is an
+// id until load_stripe makes it a local index
+typedef struct load_half {
+	uint64_t src;
+	uint64_t dst;
+} load_half;
+
+// A batch split by stripe, for load_stripe
+typedef struct load_job {
+	load_half *halves;
+	size_t start[MAP_STRIPES + 1];	// halves of stripe s are [start[s], start[s + 1])
+	uint64_t added;			// halves that weren't stored yet
+} load_job;
+
+static int cmp_half(const void *a, const void *b) {
+	const load_half *x = a, *y = b;
+	if (x->src != y->src) return (x->src > y->src) - (x->src < y->src);
+	return (x->dst > y->dst) - (x->dst < y->dst);
+}
+
+// Merges n sorted local indices, which may repeat, into l in one pass;
+// returns how many weren't in it
+static uint32_t adj_merge(adj_list *l, const uint32_t *ids, uint32_t n) {
+	uint32_t *old = l->ids, *out;
+	uint32_t on = l->n, i = 0, j = 0, k = 0, cap = ADJ_INIT;
+
+	if (l->hub) {
+		for (i = 0; i < n; i++) k += adj_insert(l, ids[i]);
+		return k;
+	}
+	if (l->packed) {
+		old = malloc(on * sizeof(uint32_t));
+		if (!old) exit(1);
+		adj_copy(l, old);
+	}
+	out = malloc((on + n) * sizeof(uint32_t));
+	if (!out) exit(1);
+	while (i < on || j < n) {
+		uint32_t next = j == n || (i < on && old[i] <= ids[j]) ? old[i] : ids[j];
+		if (i < on && old[i] == next) i++;
+		while (j < n && ids[j] == next) j++;
+		out[k++] = next;
+	}
+	if (old != l->ids) free(old);
+
+	if (k > on && adj_compress) {
+		// everything goes into one packed list, the buffer is emptied
+		adj_packed *packed = l->packed;
+		l->packed = pack_ids(out, k);
+		adj_release(packed, packed ? packed->size : 0);
+		adj_release(l->ids, l->cap * sizeof(uint32_t));
+		l->ids = NULL;
+		l->cap = 0;
+		l->n = k;
+	} else if (k > on) {
+		while (cap < k) cap *= 2;
+		adj_release(l->ids, l->cap * sizeof(uint32_t));
+		l->ids = adj_alloc(cap * sizeof(uint32_t));
+		memcpy(l->ids, out, k * sizeof(uint32_t));
+		l->cap = cap;
+		l->n = k;
+		if (l->n > hub_threshold) hub_promote(l);
+	}
+	free(out);
+	return k - on;
+}
+
+// pool_for body: sorts the halves of stripes [lo, hi) and adds the
+// vertices that are missing
+static void load_vertices(size_t lo, size_t hi, void *arg) {
+	load_job *job = arg;
+	size_t s, i;
+
+	for (s = lo; s < hi; s++) {
+		load_half *h = job->halves + job->start[s];
+		size_t n = job->start[s + 1] - job->start[s];
+
+		if (!n) continue;
+		qsort(h, n, sizeof(load_half), cmp_half);
+		pthread_rwlock_wrlock(&map.stripes[s].lock);
+		for (i = 0; i < n; i++)
+			if (!i || h[i].src != h[i - 1].src) add_vertex(h[i].src);
+		pthread_rwlock_unlock(&map.stripes[s].lock);
+	}
+}
+
+// pool_for body: loads the halves of stripes [lo, hi)
+static void load_stripe(size_t lo, size_t hi, void *arg) {
+	load_job *job = arg;
+	uint32_t *ids = NULL;
+	size_t ids_cap = 0, s;
+
+	for (s = lo; s < hi; s++) {
+		load_half *h = job->halves + job->start[s];
+		size_t n = job->start[s + 1] - job->start[s], i = 0;
+		uint64_t added = 0;
+
+		if (!n) continue;
+		// every endpoint was added by load_vertices and is pinned, so
+		// none is missing
+		ebr_enter();
+		for (i = 0; i < n; i++) h[i].dst = ret_vertex(h[i].dst)->idx;
+		ebr_exit();
+		pthread_rwlock_wrlock(&map.stripes[s].lock);
+		i = 0;
+		while (i < n) {
+			uint64_t src = h[i].src;
+			size_t m = 0;
+			vertex *v = ret_vertex(src);
+
+			for (; i < n && h[i].src == src; i++) {
+				if (m == ids_cap) {
+					ids_cap = ids_cap ? ids_cap * 2 : 1024;
+					ids = realloc(ids, ids_cap * sizeof(uint32_t));
+					if (!ids) exit(1);
+				}
+				ids[m++] = h[i].dst;
+			}
+			// still grouped by src, but dst is in id order
+			qsort(ids, m, sizeof(uint32_t), cmp_idx);
+			write_begin(v);
+			added += adj_merge(&v->adj, ids, m);
+			write_end(v);
+		}
+		pthread_rwlock_unlock(&map.stripes[s].lock);
+		__atomic_add_fetch(&job->added, added, __ATOMIC_RELAXED);
+	}
+	free(ids);
+}
+
+// Returns the number of the stripe owning vertex id
+static inline size_t stripe_index(uint64_t id) {
+	return stripe_of(id) - map.stripes;
+}
+
+// Adds the n edges in pairs (2n ids: a, b, a, b, ...), creating missing
+// endpoints; returns how many weren't in the graph. Self loops are skipped.
+uint64_t load_edges(const uint64_t *pairs, size_t n) {
+	load_job *job = calloc(1, sizeof(load_job));
+	size_t fill[MAP_STRIPES];
+	uint64_t added;
+	size_t i, s;
+
+	if (!job) exit(1);
+	for (i = 0; i < n; i++) {
+		uint64_t a = pairs[2 * i], b = pairs[2 * i + 1];
+		if (a == b) continue;
+		job->start[stripe_index(a) + 1]++;
+		job->start[stripe_index(b) + 1]++;
+	}
+	for (s = 0; s < MAP_STRIPES; s++) {
+		job->start[s + 1] += job->start[s];
+		fill[s] = job->start[s];
+	}
+	job->halves = malloc((job->start[MAP_STRIPES] + 1) * sizeof(load_half));
+	if (!job->halves) exit(1);
+	for (i = 0; i < n; i++) {
+		uint64_t a = pairs[2 * i], b = pairs[2 * i + 1];
+		if (a == b) continue;
+		job->halves[fill[stripe_index(a)]++] = (load_half) { a, b };
+		job->halves[fill[stripe_index(b)]++] = (load_half) { b, a };
+	}
+
+	load_pin();
+	pool_for(MAP_STRIPES, 1, load_vertices, job);
+	pool_for(MAP_STRIPES, 1, load_stripe, job);
+	load_unpin();
+
+	// both halves of a new edge were added
+	added = job->added / 2;
+	if (added) {
+		__atomic_add_fetch(&map.esize, added, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&map.version, 1, __ATOMIC_RELEASE);
+	}
+	free(job->halves);
+	free(job);
+	// the vertices added aren't acknowledged before the peers' filters cover them
+	filter_sync();
+	return added;
 }
 
 /*
@@ -221,8 +1689,7 @@ queue * queueCreate(void){
 // Enqueues element value to queue *q
 void enqueue(queue **q, uint64_t value){
 	struct elt *e;
-	e = malloc(sizeof(struct elt));
-	assert(e);
+	e = slab_alloc(sizeof(struct elt));
 	e->value = value;
 	e->next = 0;
 	if((*q)->head == 0) {
@@ -244,7 +1711,7 @@ uint64_t dequeue(queue **q){
 
 	e = (*q)->head;
 	(*q)->head = e->next;
-	free(e);
+	slab_free(e, sizeof(struct elt));
 	return ret;
 
 }
@@ -263,24 +1730,319 @@ void queue_destroy(queue **q){
 */
 // Given a valid node_id, returns list of neighbors
 uint64_t *get_neighbors(uint64_t id, int* n){
-	vertex *v = ret_vertex(id);
-	int size = 0;
-	int i;
-	
-	edge *runner;
-	runner = v->head;
-	while(runner){
-		size++;
-		runner = runner->next;
-	}	
-
-	uint64_t *neighbors = malloc(sizeof(uint64_t)*size);
-
-	runner = v->head;
-	for (i=0; i<size; i++){
-		neighbors[i] = runner->b;
-		runner = runner->next;
-	}
-	*n = size;
+	vertex *v;
+	adj_list l;
+	uint32_t seq;
+	uint64_t *neighbors = NULL;
+	csr_snapshot *s;
+
+	ebr_enter();
+	*n = 0;
+	// an unchanged graph can be answered from the snapshot
+	if ((s = csr_fresh())) {
+		int64_t i = csr_find(s, id);
+		if (i >= 0) {
+			uint64_t k, lo = s->offsets[i], hi = s->offsets[i + 1];
+			neighbors = malloc(sizeof(uint64_t) * (hi - lo));
+			for (k = lo; k < hi; k++) neighbors[k - lo] = s->ids[s->neighbors[k]];
+			*n = hi - lo;
+		}
+		ebr_exit();
+		return neighbors;
+	}
+	v = ret_vertex(id);
+	if (v) {
+		do {
+			free(neighbors);
+			seq = adj_snapshot(v, &l);
+			neighbors = malloc(sizeof(uint64_t) * l.n);
+			adj_ids(&l, neighbors);
+		} while (!read_valid(v, seq));
+		*n = l.n;
+	}
+	ebr_exit();
 	return neighbors;
 }
+
+// Copies into out, in ascending id order, up to max neighbors of vertex
+// id, those above *after if after isn't NULL; returns how many, -1 if id
+// isn't in the graph. An up to date snapshot keeps each list in id order
+// too, so the cursor is bisected there and the page copied straight out.
+// Live lists are in local index order, so the whole list is looked at
+// and the max smallest ids above the cursor are kept in a max-heap. The
+// cursor is only a bound, and needn't be a vertex.
+int64_t get_neighbor_page(uint64_t id, const uint64_t *after, uint32_t max, uint64_t *out) {
+	vertex *v;
+	adj_list l;
+	uint32_t seq, cap = 0, k = 0, i;
+	uint32_t *idx = NULL;
+	csr_snapshot *s;
+
+	ebr_enter();
+	v = ret_vertex(id);
+	if (!v) {
+		ebr_exit();
+		return -1;
+	}
+	if ((s = csr_fresh()) && v->idx < s->nvertices) {
+		uint64_t lo = s->offsets[v->idx], hi = s->offsets[v->idx + 1], end = hi, mid;
+		// first position whose id is above the cursor
+		while (after && lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (s->ids[s->by_id[mid]] <= *after) lo = mid + 1;
+			else hi = mid;
+		}
+		for (; lo < end && k < max; lo++) out[k++] = s->ids[s->by_id[lo]];
+		ebr_exit();
+		return k;
+	} else {
+		do {
+			seq = adj_snapshot(v, &l);
+			if (l.n > cap) {
+				free(idx);
+				cap = l.n;
+				idx = malloc(cap * sizeof(uint32_t));
+				if (!idx) exit(1);
+			}
+			adj_copy(&l, idx);
+			k = 0;
+			for (i = 0; i < l.n; i++) {
+				vertex *w = vertex_at(idx[i]);
+				// only a reader racing a writer can miss; it retries
+				if (w && (!after || w->id > *after)) heap_offer(out, &k, max, w->id);
+			}
+		} while (!read_valid(v, seq));
+	}
+	ebr_exit();
+	free(idx);
+	heap_sort(out, k);
+	return k;
+}
+
+// Returns the degree of vertex id, or -1 if it isn't in the graph. The
+// list's count is kept by every write to it, so only the vertex record
+// is read, never the neighbors.
+int64_t get_degree(uint64_t id) {
+	vertex *v;
+	adj_list l;
+	uint32_t seq;
+	int64_t d = -1;
+
+	ebr_enter();
+	v = ret_vertex(id);
+	if (v) {
+		do {
+			seq = adj_snapshot(v, &l);
+			d = l.n;
+		} while (!read_valid(v, seq));
+	}
+	ebr_exit();
+	return d;
+}
+
+// Writes the degree of each of the n vertices in ids to out, -1 for
+// those not in the graph
+void get_degrees(const uint64_t *ids, size_t n, int64_t *out) {
+	size_t i;
+
+	for (i = 0; i < n; i++) out[i] = get_degree(ids[i]);
+}
+
+// Returns the neighbors of the vertices in ids, sorted and without
+// duplicates, and their number in *n; ids not in the graph are skipped
+uint64_t *frontier_neighbors(const uint64_t *ids, size_t count, size_t *n) {
+	uint64_t *out = NULL;
+	size_t i, j, len = 0, cap = 0;
+
+	ebr_enter();
+	for (i = 0; i < count; i++) {
+		vertex *v = ret_vertex(ids[i]);
+		adj_list l;
+		uint32_t seq;
+
+		if (!v) continue;
+		do {
+			seq = adj_snapshot(v, &l);
+			if (len + l.n > cap) {
+				while (len + l.n > cap) cap = cap ? cap * 2 : 1024;
+				out = realloc(out, cap * sizeof(uint64_t));
+				if (!out) exit(1);
+			}
+			adj_ids(&l, out + len);
+		} while (!read_valid(v, seq));
+		len += l.n;
+	}
+	ebr_exit();
+
+	// neighbors shared by several vertices are shipped once
+	if (len > 1) {
+		qsort(out, len, sizeof(uint64_t), cmp_id);
+		for (i = j = 1; i < len; i++)
+			if (out[i] != out[j - 1]) out[j++] = out[i];
+		len = j;
+	}
+	*n = len;
+	return out;
+}
+
+/*
+	Shortest path
+
+	A bidirectional BFS from both ends that expands one whole level
+	at a time, always on the side with the smaller frontier; the first
+	level on which the two searches touch holds the shortest path.
+	What a search knows about a vertex lives in side arrays indexed by
+	the vertex's dense number, and an entry only counts if its stamp
+	is the current search's, so nothing is reset per search. Arrays
+	and frontier rings belong to the thread and are kept between
+	searches, so searches on different threads run side by side.
+*/
+
+// FIFO of vertices, grown by doubling and reused by every search
+typedef struct ring {
+	vertex **buf;
+	size_t head;		// next to pop
+	size_t tail;		// next free slot
+	size_t cap;		// power of two
+} ring;
+
+// One thread's search state
+typedef struct path_state {
+	uint32_t search;	// search number; stamps are this << 1 | side
+	uint32_t *stamp;	// by vertex number: stamp of the last search to reach it
+	uint32_t *dist;		// by vertex number: distance from that side
+	uint32_t cap;		// entries in stamp and dist
+	ring rings[2];		// frontier of each side
+	uint32_t *ids;		// local indices of the neighbors being expanded
+	uint32_t ids_cap;
+} path_state;
+
+static __thread path_state path;
+
+static inline size_t ring_size(const ring *r) {
+	return r->tail - r->head;
+}
+
+static void ring_push(ring *r, vertex *v) {
+	if (ring_size(r) == r->cap) {
+		size_t cap = r->cap ? r->cap * 2 : 1024;
+		vertex **buf = malloc(cap * sizeof(vertex *));
+		size_t i;
+
+		if (!buf) exit(1);
+		for (i = r->head; i != r->tail; i++) buf[i - r->head] = r->buf[i & (r->cap - 1)];
+		free(r->buf);
+		r->buf = buf;
+		r->tail -= r->head;
+		r->head = 0;
+		r->cap = cap;
+	}
+	r->buf[r->tail++ & (r->cap - 1)] = v;
+}
+
+static inline vertex *ring_pop(ring *r) {
+	return r->buf[r->head++ & (r->cap - 1)];
+}
+
+// Grows the side arrays to cover vertex numbers below n; new entries
+// carry no stamp
+static void path_reserve(uint32_t n) {
+	uint32_t cap = path.cap ? path.cap : 1024;
+
+	if (n <= path.cap) return;
+	while (cap < n) cap *= 2;
+	path.stamp = realloc(path.stamp, cap * sizeof(uint32_t));
+	path.dist = realloc(path.dist, cap * sizeof(uint32_t));
+	if (!path.stamp || !path.dist) exit(1);
+	memset(path.stamp + path.cap, 0, (cap - path.cap) * sizeof(uint32_t));
+	path.cap = cap;
+}
+
+// Stamps v as reached by side at distance d
+static inline void path_mark(const vertex *v, uint32_t stamp, uint32_t d) {
+	// added since the search began
+	if (v->idx >= path.cap) path_reserve(v->idx + 1);
+	path.stamp[v->idx] = stamp;
+	path.dist[v->idx] = d;
+}
+
+static inline uint32_t path_stamp(const vertex *v) {
+	return v->idx < path.cap ? path.stamp[v->idx] : 0;
+}
+
+// Copies v's neighbors' local indices into path.ids, returns how many
+static uint32_t path_neighbors(const vertex *v) {
+	adj_list l;
+	uint32_t seq;
+
+	do {
+		seq = adj_snapshot(v, &l);
+		if (l.n > path.ids_cap) {
+			while (l.n > path.ids_cap) path.ids_cap = path.ids_cap ? path.ids_cap * 2 : 1024;
+			free(path.ids);
+			path.ids = malloc(path.ids_cap * sizeof(uint32_t));
+			if (!path.ids) exit(1);
+		}
+		adj_copy(&l, path.ids);
+	} while (!read_valid(v, seq));
+	return l.n;
+}
+
+// Expands the current level of side's frontier; returns the shortest
+// path through an edge to the other side's vertices, or -1 if none
+static int path_level(int side) {
+	ring *r = &path.rings[side];
+	uint32_t mine = path.search << 1 | side, theirs = mine ^ 1;
+	size_t count = ring_size(r);
+	int best = -1;
+
+	while (count--) {
+		vertex *u = ring_pop(r);
+		uint32_t du = path.dist[u->idx];
+		uint32_t i, n = path_neighbors(u);
+		for (i = 0; i < n; i++) {
+			vertex *w = vertex_at(path.ids[i]);
+			uint32_t stamp;
+			if (!w) continue;
+			stamp = path_stamp(w);
+			if (stamp == theirs) {
+				int d = du + 1 + path.dist[w->idx];
+				if (best < 0 || d < best) best = d;
+			} else if (stamp != mine) {
+				path_mark(w, mine, du + 1);
+				ring_push(r, w);
+			}
+		}
+	}
+	return best;
+}
+
+// Returns the length of the shortest path between two vertices, or -1
+// if they aren't connected or either doesn't exist
+int shortest_path(uint64_t id1, uint64_t id2) {
+	vertex *a, *b;
+	int d = -1;
+
+	ebr_enter();
+	a = ret_vertex(id1);
+	b = ret_vertex(id2);
+	if (a && a == b) d = 0;
+	else if (a && b) {
+		path_reserve(__atomic_load_n(&map.next_idx, __ATOMIC_RELAXED));
+		if (++path.search == 1u << 31) {
+			memset(path.stamp, 0, path.cap * sizeof(uint32_t));
+			path.search = 1;
+		}
+		path.rings[0].head = path.rings[0].tail = 0;
+		path.rings[1].head = path.rings[1].tail = 0;
+		path_mark(a, path.search << 1, 0);
+		ring_push(&path.rings[0], a);
+		path_mark(b, path.search << 1 | 1, 0);
+		ring_push(&path.rings[1], b);
+
+		while (d < 0 && ring_size(&path.rings[0]) && ring_size(&path.rings[1]))
+			d = path_level(ring_size(&path.rings[0]) > ring_size(&path.rings[1]));
+	}
+	ebr_exit();
+	return d;
+}
@@ -29,6 +29,7 @@
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 #include <pthread.h>
 
@@ -43,16 +44,53 @@ EXTERNC bool add_vertex(unsigned long);
 EXTERNC bool remove_vertex(unsigned long);
 EXTERNC int add_edge(unsigned long, unsigned long);
 EXTERNC bool remove_edge(unsigned long, unsigned long);
+EXTERNC int add_cross_edge(unsigned long, unsigned long);
 EXTERNC bool get_node(unsigned long);
+EXTERNC void lock_node(unsigned long, bool);
+EXTERNC void unlock_node(unsigned long);
+EXTERNC void lock_edge(unsigned long, unsigned long, bool);
+EXTERNC void unlock_edge(unsigned long, unsigned long);
+EXTERNC char *partition_ip(int);
+EXTERNC bool send_frontier(int, const uint64_t*, size_t, uint64_t**, size_t*, uint64_t*);
+EXTERNC uint64_t *frontier_neighbors(const uint64_t*, size_t, size_t*);
+EXTERNC bool send_edges(int, const uint64_t*, size_t);
+EXTERNC uint64_t load_edges(const uint64_t*, size_t);
+EXTERNC int receive_edges(const uint64_t*, size_t);
+EXTERNC bool send_ops(int, const uint64_t*, size_t, uint64_t*);
+EXTERNC void apply_ops(const uint64_t*, size_t, uint64_t*);
+EXTERNC bool send_common(int, const uint64_t*, size_t, uint64_t*);
+EXTERNC uint64_t count_common(const uint64_t*, size_t);
+EXTERNC int send_filter(int, const uint64_t*, size_t);
+EXTERNC void filter_receive(const uint64_t*, size_t);
+EXTERNC void filter_sync(void);
 
 #undef EXTERNC
 
+// Deadlines of the RPCs to other partitions, so a peer that hangs fails
+// the call instead of holding up its caller: one vertex or edge, and a
+// batch (frontier, bulk edges, ops or common neighbors)
+#define RPC_DEADLINE_MS (5000)
+#define RPC_BATCH_DEADLINE_MS (60000)
+
 /*
 	Hashtable API prototypes
 */
 
-// Size of hashtable
-#define SIZE (100000)
+// Initial number of slots in each stripe's vertex index
+#define INIT_CAPACITY (256)
+// Lock stripes of the vertex map
+#define MAP_STRIPE_BITS (6)
+#define MAP_STRIPES (1 << MAP_STRIPE_BITS)
+// Control bytes compared per probe
+#define GROUP_WIDTH (16)
+// Old-array groups moved into the new one per insert while growing
+#define MIGRATE_GROUPS (8)
+// Control byte values; live slots hold the low 7 bits of the hash
+#define CTRL_EMPTY ((int8_t) -128)
+#define CTRL_DELETED ((int8_t) -2)
+// Local index directory: chunks of 1 << IDX_CHUNK_BITS vertex pointers
+#define IDX_CHUNK_BITS (16)
+#define IDX_CHUNKS (1 << (32 - IDX_CHUNK_BITS))
 
 // Queue for doing BFS and tracking nodes
 struct elt {
@@ -66,34 +104,177 @@ typedef struct queue{
     struct elt *tail;
 } queue;
 
-// Edge node definition
-typedef struct edge {
-	uint64_t b;		// adjacent vertex
-	struct edge* next;	// for chaining
-} edge;
+// Start of one block of a compressed neighbor list
+typedef struct adj_block {
+	uint32_t first;		// first index, stored in full
+	uint32_t off;		// where the gaps to the rest start in the stream
+	uint32_t n;		// indices in the block
+} adj_block;
+
+// Immutable delta-varint encoding of a sorted run of neighbor indices
+typedef struct adj_packed {
+	uint32_t n;		// indices encoded
+	uint32_t nblocks;
+	uint32_t len;		// bytes of varint stream after the blocks
+	uint32_t size;		// bytes allocated
+	adj_block blocks[];
+} adj_packed;
+
+// Neighbors, as local indices: a sorted array, or a hash set once the
+// vertex is a hub. In compressed mode the array is a small sorted write
+// buffer in front of packed, which holds the rest.
+typedef struct adj_list {
+	uint32_t *ids;
+	uint32_t n;		// neighbors in use, packed ones included
+	uint32_t cap;		// neighbors allocated
+	bool hub;		// ids is a hash set with ADJ_EMPTY holes
+	adj_packed *packed;	// compressed mode only, NULL until first merge
+} adj_list;
 
 // Vertex node definition
 typedef struct vertex {
 	uint64_t id;		// unique id of vertex
-	edge* head; 		// linked list of edges
-	struct vertex* next;	// for chaining
-	int path;
-	int visited;
+	adj_list adj;		// sorted local indices of the neighbors
+	uint32_t seq;		// odd while adj is being written
+	uint32_t idx;		// local index: dense, in order of creation
 } vertex;
 
+// Open-addressing slot
+typedef struct id_slot {
+	uint64_t key;
+	void *val;
+} id_slot;
+
+// One backing array of an id_table
+typedef struct id_array {
+	int8_t *ctrl;		// one control byte per slot
+	id_slot *slots;
+	size_t cap;		// power of two, at least GROUP_WIDTH
+	size_t used;		// live slots
+	size_t tombs;		// deleted slots
+} id_array;
+
+// Growable open-addressing table from 64-bit ids to pointers
+typedef struct id_table {
+	id_array *cur;		// receives all inserts
+	id_array *old;		// being drained into cur while growing
+	size_t drain;		// next group of old to move
+	size_t size;		// live entries across both arrays
+	uint32_t seq;		// odd while entries move between arrays
+} id_table;
+
+// One lock stripe of the vertex map: the vertices hashed to it and
+// their neighbor lists
+typedef struct vertex_stripe {
+	pthread_rwlock_t lock;
+	id_table index;		// vertices this partition owns
+	id_table ghosts;	// other partitions' vertices with an edge here
+} __attribute__((aligned(64))) vertex_stripe;
+
 // Vertex hashtable definition
 typedef struct vertex_map {
-	vertex** table;
-	size_t nsize;
+	vertex_stripe stripes[MAP_STRIPES];
+	size_t nsize;		// vertices owned, ghosts left out
 	size_t esize;
+	size_t ghosts;		// ghosts stored
+	size_t reclaimed;	// ghosts dropped with their last edge
+	size_t reused;		// local indices of reclaimed ghosts handed out again
+	size_t hubs;		// vertices currently using a hub set
+	size_t promotions;	// sorted array -> hub set conversions
+	size_t demotions;	// hub set -> sorted array conversions
+	uint64_t version;	// bumped by every change to the graph
+	size_t adj_bytes;	// bytes allocated to neighbor lists
+	uint32_t next_idx;	// local indices handed out, reclaimed ones included
+	vertex **by_idx[IDX_CHUNKS];	// local index -> vertex, chunks allocated on demand
 } vertex_map;
 
+/*
+	Slab allocator prototypes
+*/
+
+// Bytes mapped per slab
+#define SLAB_BYTES (256 * 1024)
+// Largest request served from slabs; bigger ones go to malloc
+#define SLAB_MAX (16 * 1024)
+// 8..64 in steps of 8, then 128..SLAB_MAX in powers of two
+#define SLAB_CLASSES (16)
+// Objects moved between a thread cache and its class at a time
+#define SLAB_BATCH (32)
+
+// Returns size bytes of storage
+void *slab_alloc(size_t size);
+// Releases p, which was allocated with the same size
+void slab_free(void *p, size_t size);
+// Returns the number of slabs mapped across all classes
+size_t slab_count(void);
+
+/*
+	Epoch-based reclamation prototypes
+*/
+
+// Retirements between attempts to advance the global epoch
+#define EBR_BATCH (64)
+
+// Starts a read-side critical section; may be nested
+void ebr_enter(void);
+// Ends a read-side critical section
+void ebr_exit(void);
+// Frees p (size bytes from slab_alloc) once no reader can still see it
+void ebr_retire(void *p, size_t size);
+// Frees whatever this thread retired that is now safe; for threads
+// that retire too rarely to get there on their own
+void ebr_flush(void);
+// Advances the global epoch if it can, and returns it; what was given
+// up in epoch e can be reused once it reaches e + 2
+uint64_t ebr_epoch(void);
+
+/*
+	Open-addressing index prototypes
+*/
+
+// Initializes an empty table with room for about cap entries
+void idt_init(id_table *t, size_t cap);
+// Returns the value stored for key, or NULL if it doesn't exist; needs
+// no lock, but must run between ebr_enter and ebr_exit
+void *idt_find(id_table *t, uint64_t key);
+// Adds key -> val, returns false if key existed
+bool idt_insert(id_table *t, uint64_t key, void *val);
+// Removes key, returns its value or NULL if it didn't exist
+void *idt_erase(id_table *t, uint64_t key);
+// Calls fn(key, val, arg) on every entry; may race writers, see hashtable.c
+void idt_scan(id_table *t, void (*fn)(uint64_t, void *, void *), void *arg);
+// Advances *pos (start at 0) to the next entry, returns false when done
+bool idt_next(id_table *t, size_t *pos, uint64_t *key, void **val);
+
+// Initializes the global vertex map
+void init_map(void);
+// Calls fn(id, vertex, arg) on every vertex without locking
+void map_scan(void (*fn)(uint64_t, void *, void *), void *arg);
+// Locks the stripe of vertex id, shared unless write is set; readers of
+// the store don't need it, only writers and multi-step operations do
+void lock_node(uint64_t id, bool write);
+// Unlocks the stripe of vertex id
+void unlock_node(uint64_t id);
+// Locks the stripes of both endpoints in a fixed order
+void lock_edge(uint64_t a, uint64_t b, bool write);
+// Unlocks the stripes of both endpoints
+void unlock_edge(uint64_t a, uint64_t b);
+// Write-locks the stripes of the n ids, each once and in the order
+// lock_edge uses; returns the stripes taken, one bit each
+uint64_t lock_stripes(const uint64_t *ids, size_t n);
+// Unlocks the stripes lock_stripes took
+void unlock_stripes(uint64_t taken);
 // Returns hash value
-int hash_vertex(uint64_t id);
+uint64_t hash_vertex(uint64_t id);
 // return true if vertices the same 
 bool same_vertex(uint64_t a, uint64_t b);
 // returns pointer to vertex, or NULL if it doesn't exist
 vertex * ret_vertex(uint64_t id);
+// Returns the vertex with local index idx, or NULL if there is none yet;
+// needs no lock
+vertex *vertex_at(uint32_t idx);
+// Returns the id of the vertex with local index idx, which must exist
+uint64_t id_at(uint32_t idx);
 // adds vertex, returns false is vertex existed
 bool add_vertex(uint64_t id);
 // helper, returns false if vertex does not exist
@@ -102,30 +283,120 @@ bool delete_vertex(vertex** head, uint64_t id);
 bool remove_vertex(uint64_t id);
 // checks if a vertex is in a graph
 bool get_node(uint64_t id);
+// Drops ghost id if no edge here touches it any more; the caller holds
+// the write lock of its stripe
+void reclaim_ghost(uint64_t id);
+// Adds an edge across partitions, with the far endpoint as a ghost that
+// is only kept if the edge is added; returns add_edge's code
+int add_cross_edge(uint64_t a, uint64_t b);
 // checks if an edge is in a graph
 bool get_edge(uint64_t a, uint64_t b);
 // get array of neighbors
 uint64_t *get_neighbors(uint64_t id, int* n); 
-// finds shortest path between two nodes
-int shortest_path(uint64_t id1, uint64_t id2);
 // For testing, print all nodes
 void all_nodes();
 
 /*
-	Linked-list API prototypes
+	Adjacency API prototypes
 */
 
-// Inserts node in given LL
-void LL_insert(edge** head, uint64_t n);
-// Returns true if n is in given linked list
-bool LL_contains(edge** head, uint64_t n);
-// Removes n from linked list
-bool LL_delete(edge** head, uint64_t n);
+// First allocation of a neighbor array
+#define ADJ_INIT (4)
+// Window below which adj_contains stops bisecting and scans
+#define ADJ_SCAN (16)
+// Default degree above which a vertex switches to a hub set
+#define ADJ_HUB_DEFAULT (1024)
+// Marks a free slot in a hub set, so no vertex gets this local index
+#define ADJ_EMPTY (UINT32_MAX)
+
+// Indices per block of a compressed list
+#define ADJ_BLOCK (64)
+// Write buffer size below which a compressed list never merges
+#define ADJ_BUF_MIN (8)
+// A compressed list merges once its buffer is over 1/ADJ_BUF_RATIO of it
+#define ADJ_BUF_RATIO (16)
+
+// Degree above which a vertex switches to a hub set (-d on the command line)
+extern uint32_t hub_threshold;
+// Store neighbor lists delta-varint compressed (-z on the command line);
+// set before the first vertex is added
+extern bool adj_compress;
+
+// Returns true if local index n is in the adjacency list
+bool adj_contains(const adj_list *l, uint32_t n);
+// Inserts n, returns false if it was there
+bool adj_insert(adj_list *l, uint32_t n);
+// Removes n from the list, returns false if it wasn't there
+bool adj_delete(adj_list *l, uint32_t n);
+// Copies the neighbors' local indices into out, which must hold l->n
+void adj_copy(const adj_list *l, uint32_t *out);
+// Copies the neighbors' ids into out, which must hold l->n
+void adj_ids(const adj_list *l, uint64_t *out);
+// Copies a consistent header of v's neighbor list into l, returns its seq
+uint32_t adj_snapshot(const vertex *v, adj_list *l);
+// Returns true if v hasn't been written since seq was read
+bool read_valid(const vertex *v, uint32_t seq);
 // Adds edge, returns 400, 204 or 200
 int add_edge(uint64_t a, uint64_t b);
 // Removes edge, returns false if it didn't exist
 bool remove_edge(uint64_t a, uint64_t b);
 
+/*
+	Existence set API
+*/
+
+// Values of a chunk kept as a sorted array before it becomes a bitmap
+#define EXIST_ARRAY_MAX (4096)
+// First allocation of a chunk's array
+#define EXIST_ARRAY_INIT (4)
+// Locks shared by the chunks, for writers
+#define EXIST_LOCKS (64)
+
+// Initializes the empty set; called by init_map
+void exist_init(void);
+// Adds id; the caller holds the write lock of id's stripe
+void exist_add(uint64_t id);
+// Returns true if id is in the set; needs no lock
+bool exist_test(uint64_t id);
+// Returns the bytes the set takes
+size_t exist_bytes(void);
+
+/*
+	CSR snapshot prototypes
+*/
+
+// How often the background thread looks at map.version
+#define CSR_INTERVAL_MS (1000)
+// Writes since the last snapshot that force a rebuild even under load
+#define CSR_REBUILD_DELTA (100000)
+
+// Immutable compressed-sparse-row copy of the partition
+typedef struct csr_snapshot {
+	uint64_t version;	// map.version the build started from
+	size_t nvertices;
+	size_t nedges;		// neighbors allocated; offsets[nvertices] in use
+	uint64_t *ids;		// vertex ids by local index; a vertex's number is its index
+	uint64_t *offsets;	// nvertices + 1 bounds into neighbors
+	uint32_t *neighbors;	// local indices, sorted within each range
+	uint32_t *by_id;	// the same ranges, each sorted by the vertices' ids
+	uint64_t *owned;	// bitmap of the numbers holding a vertex owned here
+} csr_snapshot;
+
+// Builds a snapshot of the partition and publishes it, unless one as
+// recent was published while it waited for another build
+void csr_build(void);
+// Returns the snapshot if the graph hasn't changed since it was built,
+// NULL otherwise; call between ebr_enter and ebr_exit
+csr_snapshot *csr_fresh(void);
+// Returns the latest snapshot, however stale, or NULL; same rules
+csr_snapshot *csr_latest(void);
+// Returns the number of id in s, or -1 if it has none
+int64_t csr_find(const csr_snapshot *s, uint64_t id);
+// Returns the version of the latest snapshot, 0 if none, and its build time
+uint64_t csr_stats(uint64_t *build_ms);
+// Background rebuild loop, for pthread_create
+void *csr_thread(void *arg);
+
 /*
 	Queue prototypes
 */
@@ -143,10 +414,278 @@ void queue_destroy(queue **q);
 	Graph API
 */
 
-// Assumes both nodes exist; returns value of shortest path
+// Neighbors per page when get_neighbors has an after but no limit, and
+// the most a page may ask for
+#define NEIGHBORS_PAGE (1000)
+#define NEIGHBORS_PAGE_MAX (1 << 20)
+// Neighbors per chunk of a streamed list
+#define NEIGHBORS_CHUNK (4096)
+// Send buffer bytes below which a stream writes its next chunk
+#define NEIGHBORS_LOW (64 << 10)
+
+// Returns the length of the shortest path between two vertices, or -1
+// if they aren't connected or either doesn't exist
 int shortest_path(uint64_t id1, uint64_t id2);
 // Given a valid node_id, returns list of neighbors
 uint64_t *get_neighbors(uint64_t id, int* n);
+// Copies into out, in ascending id order, up to max neighbors of vertex
+// id, those above *after if after isn't NULL; returns how many, -1 if id
+// isn't in the graph
+int64_t get_neighbor_page(uint64_t id, const uint64_t *after, uint32_t max, uint64_t *out);
+// Returns the degree of vertex id, or -1 if it isn't in the graph
+int64_t get_degree(uint64_t id);
+// Writes the degree of each of the n vertices in ids to out, -1 for
+// those not in the graph
+void get_degrees(const uint64_t *ids, size_t n, int64_t *out);
+
+/*
+	Distributed shortest path API
+*/
+
+// Number of partitions vertices are spread over, by id % PARTITIONS
+#define PARTITIONS (3)
+
+// Returns the length of the shortest path between two vertices over all
+// partitions, -1 if they aren't connected, or -2 if a partition couldn't
+// be reached; *levels and *bytes get the BFS levels expanded and the
+// frontier bytes shipped to other partitions
+int distributed_path(uint64_t id1, uint64_t id2, uint32_t *levels, uint64_t *bytes);
+// Returns the number of distributed searches run, and their total
+// levels and bytes shipped
+uint64_t path_stats(uint64_t *levels, uint64_t *bytes);
+
+/*
+	k-hop neighborhood API
+*/
+
+// Largest k a k-hop query may ask for
+#define KHOP_MAX_K (64)
+
+// Outcome of a k-hop query
+typedef struct khop_result {
+	uint64_t *ids;		// the vertices reached, sorted, if asked for
+	uint64_t count;		// vertices reached, the source left out
+	uint64_t level[KHOP_MAX_K];	// of them, those first reached at each level
+	uint64_t bytes;		// frontier bytes shipped to other partitions
+	uint32_t levels;	// levels expanded
+	bool truncated;		// stopped at the limit
+} khop_result;
+
+// Fills r with the vertices within k hops of id over all partitions, id
+// itself left out, stopping once limit have been reached; with ids set,
+// r->ids gets them sorted, to be freed by the caller. Returns 0, or -2
+// if a partition couldn't be reached.
+int distributed_khop(uint64_t id, uint32_t k, uint64_t limit, bool ids, khop_result *r);
+
+/*
+	Intersection API
+*/
+
+// Look ids of the shorter list up in the longer one, rather than merge
+// the two, once the longer is this many times longer
+#define ISECT_GALLOP (32)
+
+// Intersects sorted a and b; out, if not NULL, gets the ids in both, in
+// order, and must hold the shorter list. Returns how many there are.
+size_t intersect_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out);
+// Intersects sorted a and b like intersect_u32, for 64-bit ids
+size_t intersect_u64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *out);
+// Returns the number of common neighbors of a and b over all partitions,
+// or -2 if a partition couldn't be reached; deg gets their degrees, and
+// *common, if common isn't NULL, the common neighbors sorted, to be freed
+// by the caller
+int64_t common_neighbors(uint64_t a, uint64_t b, uint64_t **common, uint64_t *deg);
+// Returns the number of triangles through vertex id over all partitions,
+// or -2 if a partition couldn't be reached; *deg gets its degree
+int64_t triangle_count(uint64_t id, uint64_t *deg);
+
+/*
+	Work-stealing pool API
+*/
+
+// Tasks a worker's deque holds, a power of two
+#define POOL_DEQUE (1024)
+
+// Starts n workers; with none, pool_submit and pool_for run in the caller
+void pool_init(int n);
+// Returns the number of workers
+int pool_size(void);
+// Runs fn(0, 0, arg) on a worker and returns at once
+void pool_submit(void (*fn)(size_t, size_t, void *), void *arg);
+// Runs fn(lo, hi, arg) over [0, n) in chunks of at most chunk ids, in
+// parallel when called on a worker, and returns once every chunk is done
+void pool_for(size_t n, size_t chunk, void (*fn)(size_t, size_t, void *), void *arg);
+
+/*
+	Direction-optimizing BFS API
+*/
+
+// Go bottom-up once the frontier has more than 1 / BFS_ALPHA of the
+// unvisited vertices' edges, back top-down below nvertices / BFS_BETA
+#define BFS_ALPHA (14)
+#define BFS_BETA (24)
+// Bitmap words, of 64 vertices each, per chunk of a level run on the pool
+#define BFS_CHUNK (64)
+
+// Outcome of a BFS
+typedef struct bfs_result {
+	uint64_t reached;	// owned vertices reached, the source included
+	uint64_t edges;		// neighbor entries examined
+	uint32_t levels;	// greatest distance from the source
+	uint32_t bottom_up;	// steps run bottom-up
+	bool stale;		// the snapshot predates a write
+} bfs_result;
+
+// Runs a BFS over s from vertex number source, filling r; depth, if not
+// NULL, gets each vertex's distance from source, or -1 if unreachable
+void bfs_run(const csr_snapshot *s, uint32_t source, int32_t *depth, bfs_result *r);
+// Runs a BFS over the partition from id, filling r; returns false if id
+// isn't in the partition
+bool bfs_from(uint64_t id, bfs_result *r);
+
+/*
+	Bulk load API
+*/
+
+// Bytes of a bulk load stream handed to the pool as one batch
+#define LOAD_BATCH (8 << 20)
+// Bytes of text each parse task of a batch takes
+#define LOAD_CHUNK (256 << 10)
+// Edges per add_edges RPC, well under gRPC's default 4MB message limit
+#define LOAD_RPC_EDGES (65536)
+// Batches of one stream in flight before it stops reading the socket
+#define LOAD_INFLIGHT (4)
+
+// Counts of a bulk load
+typedef struct load_result {
+	uint64_t edges;		// edges read
+	uint64_t added;		// edges new to this partition
+	uint64_t shipped;	// edges sent to other partitions
+	uint64_t bad;		// malformed records and self loops
+	bool failed;		// a partition couldn't be reached
+} load_result;
+
+// Adds the n edges in pairs (2n ids: a, b, a, b, ...), creating missing
+// endpoints; returns how many weren't in the graph. Self loops are skipped.
+uint64_t load_edges(const uint64_t *pairs, size_t n);
+// Parses len bytes of edges, as 16-byte little-endian pairs if binary or
+// else as lines "a b", loads those touching this partition and ships
+// each one to the other partition owning an endpoint; adds to r
+void load_batch(const char *buf, size_t len, bool binary, load_result *r);
+// Loads the edges another partition shipped, n ids in pairs; returns 200,
+// or 400 if they aren't all edges touching this partition
+int receive_edges(const uint64_t *ids, size_t n);
+
+/*
+	Batch API
+*/
+
+// Ops of a batch besides the log's ADD_NODE, ADD_EDGE, REMOVE_EDGE
+// and GET_NODE
+#define GET_EDGE (5)
+#define GET_NEIGHBORS (6)
+// Marks an op that couldn't be parsed
+#define BAD_OP (~0ULL)
+// Ops a batch may hold
+#define BATCH_MAX (65536)
+
+// An op of a batch and its result
+typedef struct batch_op {
+	uint64_t op;		// one of the op codes above
+	uint64_t a;		// node_id or node_a_id
+	uint64_t b;		// node_b_id
+	int code;		// http code of the result
+	int n;			// neighbors found, for GET_NEIGHBORS
+	uint64_t *neighbors;
+	uint32_t at[2];		// a's and b's places in their partitions' RPCs
+} batch_op;
+
+// Applies the n ops in order, setting their codes; the stripes they
+// write are locked once, and the other partitions get one RPC each
+void apply_batch(batch_op *ops, size_t n);
+// Applies n (op, a, b) triples sent by another partition's batch, in
+// order, writing a code for each
+void apply_ops(const uint64_t *ops, size_t n, uint64_t *codes);
+
+/*
+	Peer filter API
+*/
+
+// Fingerprints per bucket; a bucket is one word of 16-bit fingerprints
+#define FILTER_SLOTS (4)
+// Buckets of a new filter, a power of two
+#define FILTER_INIT_BUCKETS (1 << 10)
+// Evictions an insert tries before the filter is rebuilt twice as big
+#define FILTER_MAX_KICKS (500)
+// Buckets of the largest filter shipped, so that one push stays under
+// gRPC's default 4MB message limit
+#define FILTER_SHIP_MAX (1 << 18)
+// How often the background thread looks for changes to ship
+#define FILTER_PUSH_MS (200)
+// How often an unchanged filter is shipped again, and how long a peer
+// trusts the copy it holds
+#define FILTER_REFRESH_MS (10000)
+#define FILTER_TTL_MS (30000)
+// Deadline of a push_filter RPC, short next to FILTER_TTL_MS, so a peer
+// that hangs can't keep the filter thread from the others' drops
+#define FILTER_RPC_MS (2000)
+
+// What send_filter says became of a push
+#define PUSH_TAKEN (1)		// the peer took it
+#define PUSH_UNSENT (0)		// the peer couldn't be reached, so it didn't
+#define PUSH_UNKNOWN (-1)	// it may have
+
+// What a peer's filter says about an id
+#define FILTER_ABSENT (0)	// not in its partition
+#define FILTER_MAYBE (1)	// perhaps in its partition
+#define FILTER_NONE (2)		// no copy to go by
+
+// Sets up the empty filter; called by init_map
+void filter_init(void);
+// Adds id, if this partition owns it; the caller holds the write lock
+// of id's stripe, and id can be found already
+void filter_add(uint64_t id);
+// Removes id, if this partition owns it
+void filter_remove(uint64_t id);
+// Waits until no peer can hold a copy that misses a vertex added
+// before the call; call with no lock held, before acknowledging adds
+void filter_sync(void);
+// Returns what the filter of the partition owning id says about it
+int filter_lookup(uint64_t id);
+// Counts a lookup that said FILTER_MAYBE for an id its owner didn't have
+void filter_false_positive(void);
+// Takes in a filter shipped by another partition
+void filter_receive(const uint64_t *words, size_t n);
+// Returns the lookups answered by a copy, and sets *negatives and
+// *false_positives to those that saved an RPC and those that didn't
+// need one
+uint64_t filter_stats(uint64_t *negatives, uint64_t *false_positives);
+// Background loop shipping the filter to the other partitions, for
+// pthread_create
+void *filter_thread(void *arg);
+
+/*
+	Remote vertex cache API
+*/
+
+// Ids per set, so that a set and its CLOCK state fill a cache line
+#define RCACHE_WAYS (7)
+// Sets, a power of two: 1 << 15 sets of 7 hold 229376 ids in 2MB
+#define RCACHE_SETS (1 << 15)
+// Locks shared by the sets, for writers
+#define RCACHE_LOCKS (64)
+
+// Sets up the empty cache; called by init_map
+void rcache_init(void);
+// Returns true if another partition confirmed it has id; needs no lock
+bool rcache_has(uint64_t id);
+// Records that the partition owning id confirmed it has it
+void rcache_add(uint64_t id);
+// Drops id, for when its partition removes it; whoever removes a vertex
+// has to have every other partition call this before acknowledging
+void rcache_forget(uint64_t id);
+// Returns the lookups made, and sets *hits to those that found the id
+uint64_t rcache_stats(uint64_t *hits);
 
 /*
 	Log functionality API
@@ -0,0 +1,503 @@
+/*
+ * intersect.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides sorted-set intersection kernels and the queries
+ * built on them: common neighbors and triangle counts
+ */
+
+#include "headers.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+// AVX2 kernels are compiled for any x86-64 build and picked at run time
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define ISECT_AVX2
+#endif
+
+extern int CHAIN_NUM;
+
+/*
+	Intersections
+
+	Both lists are sorted and hold no duplicates. The SIMD kernels
+	compare a block of one list against every rotation of a block of
+	the other, which finds all equal pairs between the two blocks in
+	a few instructions and no branches, then move on from whichever
+	block ends lower (from both if they end on the same id). The bits
+	of the match mask pick the ids found out of the first block. AVX2
+	blocks are 8 ids of 32 bits or 4 of 64, SSE2 blocks half that, and
+	the ends of the lists are merged one id at a time.
+
+	When one list is more than ISECT_GALLOP times longer than the
+	other, each id of the short one is looked up in the long one
+	instead, by doubling steps from the last match and then
+	bisecting, which costs O(short * log(long / short)).
+
+	CSR snapshots number vertices by local index, not by id, so their
+	ranges are intersected as sorted 32-bit numbers and the matches
+	turned into ids afterwards. Lists read live or fetched from
+	another partition are intersected as sorted 64-bit ids.
+*/
+
+static inline int owner(uint64_t id) {
+	return id % PARTITIONS + 1;
+}
+
+static int cmp_u32(const void *x, const void *y) {
+	uint32_t a = *(const uint32_t *) x, b = *(const uint32_t *) y;
+	return a < b ? -1 : a > b;
+}
+
+static int cmp_u64(const void *x, const void *y) {
+	uint64_t a = *(const uint64_t *) x, b = *(const uint64_t *) y;
+	return a < b ? -1 : a > b;
+}
+
+// Merges a and b one id at a time; out, if not NULL, gets the ids found
+static size_t merge_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out) {
+	size_t i = 0, j = 0, k = 0;
+
+	while (i < na && j < nb) {
+		if (a[i] < b[j]) {
+			i++;
+		} else if (a[i] > b[j]) {
+			j++;
+		} else {
+			if (out) out[k] = a[i];
+			k++;
+			i++;
+			j++;
+		}
+	}
+	return k;
+}
+
+static size_t merge_u64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *out) {
+	size_t i = 0, j = 0, k = 0;
+
+	while (i < na && j < nb) {
+		if (a[i] < b[j]) {
+			i++;
+		} else if (a[i] > b[j]) {
+			j++;
+		} else {
+			if (out) out[k] = a[i];
+			k++;
+			i++;
+			j++;
+		}
+	}
+	return k;
+}
+
+// Looks up each id of the short list a in the long list b
+static size_t gallop_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out) {
+	size_t i, j = 0, k = 0;
+
+	for (i = 0; i < na && j < nb; i++) {
+		uint32_t x = a[i];
+		size_t lo = j, hi, step = 1;
+
+		// b[lo] < x <= b[hi], or hi == nb
+		if (b[j] < x) {
+			while (lo + step < nb && b[lo + step] < x) {
+				lo += step;
+				step <<= 1;
+			}
+			hi = lo + step < nb ? lo + step : nb;
+			while (hi - lo > 1) {
+				size_t mid = lo + (hi - lo) / 2;
+				if (b[mid] < x) lo = mid;
+				else hi = mid;
+			}
+			j = hi;
+		}
+		if (j < nb && b[j] == x) {
+			if (out) out[k] = x;
+			k++;
+			j++;
+		}
+	}
+	return k;
+}
+
+static size_t gallop_u64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *out) {
+	size_t i, j = 0, k = 0;
+
+	for (i = 0; i < na && j < nb; i++) {
+		uint64_t x = a[i];
+		size_t lo = j, hi, step = 1;
+
+		if (b[j] < x) {
+			while (lo + step < nb && b[lo + step] < x) {
+				lo += step;
+				step <<= 1;
+			}
+			hi = lo + step < nb ? lo + step : nb;
+			while (hi - lo > 1) {
+				size_t mid = lo + (hi - lo) / 2;
+				if (b[mid] < x) lo = mid;
+				else hi = mid;
+			}
+			j = hi;
+		}
+		if (j < nb && b[j] == x) {
+			if (out) out[k] = x;
+			k++;
+			j++;
+		}
+	}
+	return k;
+}
+
+// Writes the ids of a selected by mask to out, if not NULL; returns how many
+static inline size_t emit_u32(const uint32_t *a, unsigned mask, uint32_t *out) {
+	size_t k = 0;
+
+	if (!out) return __builtin_popcount(mask);
+	while (mask) {
+		out[k++] = a[__builtin_ctz(mask)];
+		mask &= mask - 1;
+	}
+	return k;
+}
+
+static inline size_t emit_u64(const uint64_t *a, unsigned mask, uint64_t *out) {
+	size_t k = 0;
+
+	if (!out) return __builtin_popcount(mask);
+	while (mask) {
+		out[k++] = a[__builtin_ctz(mask)];
+		mask &= mask - 1;
+	}
+	return k;
+}
+
+#ifdef __SSE2__
+// 4 by 4 blocks of 32-bit ids
+static size_t sse2_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out) {
+	size_t i = 0, j = 0, k = 0;
+
+	while (i + 4 <= na && j + 4 <= nb) {
+		__m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+		__m128i eq = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi32(va, vb),
+				_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+			_mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+				_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+		uint32_t amax = a[i + 3], bmax = b[j + 3];
+
+		k += emit_u32(a + i, _mm_movemask_ps(_mm_castsi128_ps(eq)), out ? out + k : NULL);
+		if (amax <= bmax) i += 4;
+		if (bmax <= amax) j += 4;
+	}
+	return k + merge_u32(a + i, na - i, b + j, nb - j, out ? out + k : NULL);
+}
+#endif
+
+#ifdef ISECT_AVX2
+// 8 by 8 blocks of 32-bit ids: three rotations within each 128-bit
+// half, then the same for the block with its halves swapped
+__attribute__((target("avx2")))
+static size_t avx2_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out) {
+	size_t i = 0, j = 0, k = 0;
+
+	while (i + 8 <= na && j + 8 <= nb) {
+		__m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+		__m256i vb = _mm256_loadu_si256((const __m256i *) (b + j));
+		__m256i vs = _mm256_permute2x128_si256(vb, vb, 1);
+		__m256i eq = _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi32(va, vb),
+					_mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+				_mm256_or_si256(_mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+					_mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))))),
+			_mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi32(va, vs),
+					_mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, _MM_SHUFFLE(0, 3, 2, 1)))),
+				_mm256_or_si256(_mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, _MM_SHUFFLE(1, 0, 3, 2))),
+					_mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, _MM_SHUFFLE(2, 1, 0, 3))))));
+		uint32_t amax = a[i + 7], bmax = b[j + 7];
+
+		k += emit_u32(a + i, _mm256_movemask_ps(_mm256_castsi256_ps(eq)), out ? out + k : NULL);
+		if (amax <= bmax) i += 8;
+		if (bmax <= amax) j += 8;
+	}
+	return k + merge_u32(a + i, na - i, b + j, nb - j, out ? out + k : NULL);
+}
+
+// 4 by 4 blocks of 64-bit ids
+__attribute__((target("avx2")))
+static size_t avx2_u64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *out) {
+	size_t i = 0, j = 0, k = 0;
+
+	while (i + 4 <= na && j + 4 <= nb) {
+		__m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+		__m256i vb = _mm256_loadu_si256((const __m256i *) (b + j));
+		__m256i eq = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi64(va, vb),
+				_mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+			_mm256_or_si256(_mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+				_mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+		uint64_t amax = a[i + 3], bmax = b[j + 3];
+
+		k += emit_u64(a + i, _mm256_movemask_pd(_mm256_castsi256_pd(eq)), out ? out + k : NULL);
+		if (amax <= bmax) i += 4;
+		if (bmax <= amax) j += 4;
+	}
+	return k + merge_u64(a + i, na - i, b + j, nb - j, out ? out + k : NULL);
+}
+#endif
+
+// Intersects sorted a and b; out, if not NULL, gets the ids in both, in
+// order, and must hold the shorter list. Returns how many there are.
+size_t intersect_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out) {
+	// the shorter list first
+	if (na > nb) {
+		const uint32_t *t = a;
+		size_t n = na;
+		a = b;
+		na = nb;
+		b = t;
+		nb = n;
+	}
+	if (!na) return 0;
+	if (na * ISECT_GALLOP < nb) return gallop_u32(a, na, b, nb, out);
+#ifdef ISECT_AVX2
+	if (__builtin_cpu_supports("avx2")) return avx2_u32(a, na, b, nb, out);
+#endif
+#ifdef __SSE2__
+	return sse2_u32(a, na, b, nb, out);
+#else
+	return merge_u32(a, na, b, nb, out);
+#endif
+}
+
+// Intersects sorted a and b like intersect_u32, for 64-bit ids
+size_t intersect_u64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *out) {
+	if (na > nb) {
+		const uint64_t *t = a;
+		size_t n = na;
+		a = b;
+		na = nb;
+		b = t;
+		nb = n;
+	}
+	if (!na) return 0;
+	if (na * ISECT_GALLOP < nb) return gallop_u64(a, na, b, nb, out);
+#ifdef ISECT_AVX2
+	if (__builtin_cpu_supports("avx2")) return avx2_u64(a, na, b, nb, out);
+#endif
+	// two ids a block don't beat the merge
+	return merge_u64(a, na, b, nb, out);
+}
+
+/*
+	Common neighbors and triangles
+
+	The partition owning a vertex holds its whole neighbor list, so a
+	list is read here if this partition owns the vertex and fetched
+	from its owner with an expand_frontier RPC of one vertex if not.
+
+	A triangle through v is an edge between two of v's neighbors, so
+	v's triangles are half the sum, over its neighbors u, of the
+	common neighbors of u and v. v's sorted list goes to every
+	partition owning some of its neighbors, in one count_common RPC
+	each, and that partition adds up the intersections of the lists
+	of its own vertices among them with it. Lists here hold local
+	indices, so a list sent out is turned into ids and sorted, and the
+	ids a partition is sent are turned into local indices and sorted
+	once, to be intersected with its own lists as they are.
+*/
+
+// Returns the neighbors of vertex id as stored here, sorted, and their
+// number in *n; NULL with *n set to 0 if id isn't here
+static uint64_t *sorted_neighbors(uint64_t id, size_t *n) {
+	vertex *v;
+	adj_list l;
+	uint32_t seq;
+	uint64_t *out = NULL;
+
+	*n = 0;
+	ebr_enter();
+	v = ret_vertex(id);
+	if (v) {
+		do {
+			seq = adj_snapshot(v, &l);
+			out = realloc(out, (l.n + 1) * sizeof(uint64_t));
+			if (!out) exit(1);
+			adj_ids(&l, out);
+			*n = l.n;
+		} while (!read_valid(v, seq));
+	}
+	ebr_exit();
+	qsort(out, *n, sizeof(uint64_t), cmp_u64);
+	return out;
+}
+
+// Returns the sorted neighbors of vertex id from the partition owning
+// it, and their number in *n, or -1 if that partition can't be reached
+static uint64_t *owner_neighbors(uint64_t id, size_t *n) {
+	uint64_t *out = NULL, bytes = 0;
+
+	if (owner(id) == CHAIN_NUM) return sorted_neighbors(id, n);
+	if (!send_frontier(owner(id), &id, 1, &out, n, &bytes)) {
+		*n = (size_t) -1;
+		return NULL;
+	}
+	return out;
+}
+
+// Returns how many of the n sorted local indices are neighbors of v.
+// A hub set is probed one by one, a compressed list decoded, and a
+// sorted array intersected where it is. Call inside ebr_enter/ebr_exit.
+static size_t common_with(const vertex *v, const uint32_t *idx, size_t n) {
+	adj_list l;
+	uint32_t seq;
+	uint32_t *decoded = NULL;
+	size_t i, k;
+
+	do {
+		seq = adj_snapshot(v, &l);
+		k = 0;
+		if (l.hub) {
+			for (i = 0; i < n; i++) k += adj_contains(&l, idx[i]);
+		} else if (l.packed) {
+			decoded = realloc(decoded, (l.n + 1) * sizeof(uint32_t));
+			if (!decoded) exit(1);
+			adj_copy(&l, decoded);
+			k = intersect_u32(decoded, l.n, idx, n, NULL);
+		} else {
+			k = intersect_u32(l.ids, l.n, idx, n, NULL);
+		}
+	} while (!read_valid(v, seq));
+	free(decoded);
+	return k;
+}
+
+// Returns the sum, over the n ids owned by this partition, of the
+// number of their neighbors among ids
+uint64_t count_common(const uint64_t *ids, size_t n) {
+	// as local indices, sorted; an id that isn't here can't be in any
+	// list here either
+	uint32_t *idx = malloc((n + 1) * sizeof(uint32_t));
+	vertex **at = malloc((n + 1) * sizeof(vertex *));
+	csr_snapshot *s;
+	uint64_t total = 0;
+	size_t m = 0, i;
+
+	if (!idx || !at) exit(1);
+	ebr_enter();
+	for (i = 0; i < n; i++) {
+		at[i] = ret_vertex(ids[i]);
+		if (at[i]) idx[m++] = at[i]->idx;
+	}
+	qsort(idx, m, sizeof(uint32_t), cmp_u32);
+
+	s = csr_fresh();
+	for (i = 0; i < n; i++) {
+		vertex *v = at[i];
+		if (!v || owner(ids[i]) != CHAIN_NUM) continue;
+		if (s && v->idx < s->nvertices) {
+			total += intersect_u32(s->neighbors + s->offsets[v->idx],
+				s->offsets[v->idx + 1] - s->offsets[v->idx], idx, m, NULL);
+		} else {
+			total += common_with(v, idx, m);
+		}
+	}
+	ebr_exit();
+	free(idx);
+	free(at);
+	return total;
+}
+
+// Returns the number of common neighbors of a and b over all partitions,
+// or -2 if a partition couldn't be reached; deg gets their degrees, and
+// *common, if common isn't NULL, the common neighbors sorted, to be freed
+// by the caller
+int64_t common_neighbors(uint64_t a, uint64_t b, uint64_t **common, uint64_t *deg) {
+	csr_snapshot *s;
+	uint64_t *la, *lb;
+	size_t na, nb, k;
+
+	if (common) *common = NULL;
+	ebr_enter();
+	if (owner(a) == CHAIN_NUM && owner(b) == CHAIN_NUM && (s = csr_fresh())) {
+		int64_t ia = csr_find(s, a), ib = csr_find(s, b);
+		if (ia >= 0 && ib >= 0) {
+			uint32_t *nums = NULL;
+			na = s->offsets[ia + 1] - s->offsets[ia];
+			nb = s->offsets[ib + 1] - s->offsets[ib];
+			if (common) {
+				nums = malloc((na < nb ? na : nb) * sizeof(uint32_t) + 1);
+				*common = malloc((na < nb ? na : nb) * sizeof(uint64_t) + 1);
+				if (!nums || !*common) exit(1);
+			}
+			k = intersect_u32(s->neighbors + s->offsets[ia], na,
+				s->neighbors + s->offsets[ib], nb, nums);
+			if (common) {
+				size_t i;
+				for (i = 0; i < k; i++) (*common)[i] = s->ids[nums[i]];
+				qsort(*common, k, sizeof(uint64_t), cmp_u64);
+				free(nums);
+			}
+			ebr_exit();
+			deg[0] = na;
+			deg[1] = nb;
+			return k;
+		}
+	}
+	ebr_exit();
+
+	la = owner_neighbors(a, &na);
+	if (na == (size_t) -1) return -2;
+	lb = owner_neighbors(b, &nb);
+	if (nb == (size_t) -1) {
+		free(la);
+		return -2;
+	}
+	if (common) {
+		*common = malloc((na < nb ? na : nb) * sizeof(uint64_t) + 1);
+		if (!*common) exit(1);
+	}
+	k = intersect_u64(la, na, lb, nb, common ? *common : NULL);
+	free(la);
+	free(lb);
+	deg[0] = na;
+	deg[1] = nb;
+	return k;
+}
+
+// Returns the number of triangles through vertex id over all partitions,
+// or -2 if a partition couldn't be reached; *deg gets its degree
+int64_t triangle_count(uint64_t id, uint64_t *deg) {
+	bool has[PARTITIONS + 1] = { false };
+	uint64_t *ids, sum = 0, part;
+	size_t n, i;
+	int p;
+
+	ids = owner_neighbors(id, &n);
+	if (n == (size_t) -1) return -2;
+	*deg = n;
+	for (i = 0; i < n; i++) has[owner(ids[i])] = true;
+	for (p = 1; p <= PARTITIONS; p++) {
+		if (!has[p]) continue;
+		if (p == CHAIN_NUM) {
+			sum += count_common(ids, n);
+		} else if (send_common(p, ids, n, &part)) {
+			sum += part;
+		} else {
+			free(ids);
+			return -2;
+		}
+	}
+	free(ids);
+	// each triangle is found from both of its other corners
+	return sum / 2;
+}
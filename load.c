@@ -0,0 +1,207 @@
+/*
+ * load.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides bulk loading: parses batches of an edge stream
+ * in parallel and sends every edge to the partitions that
+ * own its endpoints
+ */
+
+#include "headers.h"
+
+extern int CHAIN_NUM;
+
+/*
+	Bulk load
+
+	A batch is parsed on the pool, LOAD_CHUNK bytes of text per task;
+	a task owns the lines that start in its range, so it skips the
+	partial line at its start and finishes the one crossing its end.
+	An edge is stored by every partition owning one of its endpoints,
+	as add_edge does, so it is loaded here if it touches this
+	partition and shipped to the other owners in add_edges RPCs of up
+	to LOAD_RPC_EDGES edges. Endpoints that don't exist yet are
+	created on the way.
+*/
+
+// Growable array of ids
+typedef struct load_vec {
+	uint64_t *ids;
+	size_t n;
+	size_t cap;
+} load_vec;
+
+// One parse task's range of text and the pairs found in it
+typedef struct load_chunk {
+	uint64_t *pairs;
+	size_t n;		// pairs found
+	size_t bad;		// malformed lines
+} load_chunk;
+
+// Text of a batch, split into chunks for load_parse
+typedef struct load_text {
+	const char *buf;
+	size_t len;
+	load_chunk *chunks;
+} load_text;
+
+static void vec_add(load_vec *v, uint64_t a, uint64_t b) {
+	if (v->n + 2 > v->cap) {
+		v->cap = v->cap ? v->cap * 2 : 1024;
+		v->ids = realloc(v->ids, v->cap * sizeof(uint64_t));
+		if (!v->ids) exit(1);
+	}
+	v->ids[v->n++] = a;
+	v->ids[v->n++] = b;
+}
+
+static inline bool is_blank(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parses a decimal id at *p, before end; returns false if there is none
+// or it doesn't fit in 64 bits
+static inline bool parse_id(const char **p, const char *end, uint64_t *id) {
+	const char *q = *p;
+	uint64_t v = 0;
+
+	if (q == end || *q < '0' || *q > '9') return false;
+	for (; q < end && *q >= '0' && *q <= '9'; q++) {
+		if (v > (UINT64_MAX - (*q - '0')) / 10) return false;
+		v = v * 10 + (*q - '0');
+	}
+	*p = q;
+	*id = v;
+	return true;
+}
+
+// Parses the line [p, end), which holds "a b", "a,b" or "a\tb"; blank
+// lines and comments (# or %) give no pair. Returns 1 for a pair, 0
+// for none and -1 for a malformed line.
+static int parse_line(const char *p, const char *end, uint64_t *a, uint64_t *b) {
+	while (p < end && is_blank(*p)) p++;
+	if (p == end || *p == '#' || *p == '%') return 0;
+	if (!parse_id(&p, end, a)) return -1;
+	if (p == end || !(is_blank(*p) || *p == ',')) return -1;
+	while (p < end && (is_blank(*p) || *p == ',')) p++;
+	if (!parse_id(&p, end, b)) return -1;
+	while (p < end && is_blank(*p)) p++;
+	return p == end ? 1 : -1;
+}
+
+// pool_for body: parses the lines starting in chunks [lo, hi)
+static void load_parse(size_t lo, size_t hi, void *arg) {
+	load_text *t = arg;
+	size_t c;
+
+	for (c = lo; c < hi; c++) {
+		load_chunk *chunk = &t->chunks[c];
+		const char *end = t->buf + t->len;
+		const char *p = t->buf + c * LOAD_CHUNK;
+		const char *stop = c * LOAD_CHUNK + LOAD_CHUNK < t->len ? p + LOAD_CHUNK : end;
+
+		// the shortest line holding a pair is "1 2\n"
+		chunk->pairs = malloc(((stop - p) / 4 + 1) * 2 * sizeof(uint64_t));
+		if (!chunk->pairs) exit(1);
+		// a line crossing into this chunk belongs to the previous one
+		if (c) {
+			while (p < stop && p[-1] != '\n') p++;
+		}
+		while (p < stop) {
+			const char *nl = memchr(p, '\n', end - p);
+			const char *eol = nl ? nl : end;
+			uint64_t a, b;
+			int r = parse_line(p, eol, &a, &b);
+			if (r > 0) {
+				chunk->pairs[2 * chunk->n] = a;
+				chunk->pairs[2 * chunk->n + 1] = b;
+				chunk->n++;
+			} else if (r < 0) {
+				chunk->bad++;
+			}
+			p = nl ? nl + 1 : end;
+		}
+	}
+}
+
+// Sends the n edges in pairs to partition part, LOAD_RPC_EDGES at a time
+static bool ship(int part, const uint64_t *pairs, size_t n) {
+	size_t i;
+
+	for (i = 0; i < n; i += LOAD_RPC_EDGES) {
+		size_t count = n - i < LOAD_RPC_EDGES ? n - i : LOAD_RPC_EDGES;
+		if (!send_edges(part, pairs + 2 * i, count)) return false;
+	}
+	return true;
+}
+
+// Loads the edges another partition shipped, n ids in pairs; returns 200,
+// or 400 without loading any if they aren't all edges touching this
+// partition, so that the sender's load fails
+int receive_edges(const uint64_t *ids, size_t n) {
+	size_t i;
+
+	if (n % 2) return 400;
+	for (i = 0; i < n; i += 2) {
+		int pa = ids[i] % PARTITIONS + 1, pb = ids[i + 1] % PARTITIONS + 1;
+		if (ids[i] == ids[i + 1] || (pa != CHAIN_NUM && pb != CHAIN_NUM)) return 400;
+	}
+	load_edges(ids, n / 2);
+	return 200;
+}
+
+// Parses len bytes of edges, as 16-byte little-endian pairs if binary or
+// else as lines "a b", loads those touching this partition and ships
+// each one to the other partition owning an endpoint; adds to r
+void load_batch(const char *buf, size_t len, bool binary, load_result *r) {
+	load_vec local = { 0 }, remote[PARTITIONS + 1] = { { 0 } };
+	load_chunk *chunks = NULL;
+	size_t nchunks = 0, c, i;
+	int p;
+
+	if (binary) {
+		// one chunk straight over the buffer
+		nchunks = 1;
+		chunks = calloc(1, sizeof(load_chunk));
+		if (!chunks) exit(1);
+		chunks[0].pairs = (uint64_t *) buf;
+		chunks[0].n = len / (2 * sizeof(uint64_t));
+		chunks[0].bad = len % (2 * sizeof(uint64_t)) != 0;
+	} else if (len) {
+		load_text t = { buf, len, NULL };
+		nchunks = (len + LOAD_CHUNK - 1) / LOAD_CHUNK;
+		t.chunks = chunks = calloc(nchunks, sizeof(load_chunk));
+		if (!chunks) exit(1);
+		pool_for(nchunks, 1, load_parse, &t);
+	}
+
+	for (c = 0; c < nchunks; c++) {
+		r->bad += chunks[c].bad;
+		for (i = 0; i < chunks[c].n; i++) {
+			uint64_t a = chunks[c].pairs[2 * i], b = chunks[c].pairs[2 * i + 1];
+			int pa = a % PARTITIONS + 1, pb = b % PARTITIONS + 1;
+
+			r->edges++;
+			if (a == b) {
+				r->bad++;
+				continue;
+			}
+			if (pa == CHAIN_NUM || pb == CHAIN_NUM) vec_add(&local, a, b);
+			if (pa != CHAIN_NUM) vec_add(&remote[pa], a, b);
+			if (pb != CHAIN_NUM && pb != pa) vec_add(&remote[pb], a, b);
+		}
+		if (!binary) free(chunks[c].pairs);
+	}
+	free(chunks);
+
+	if (local.n) r->added += load_edges(local.ids, local.n / 2);
+	free(local.ids);
+	for (p = 1; p <= PARTITIONS; p++) {
+		if (!remote[p].n) continue;
+		if (ship(p, remote[p].ids, remote[p].n / 2)) r->shipped += remote[p].n / 2;
+		else r->failed = true;
+		free(remote[p].ids);
+	}
+}
@@ -0,0 +1,270 @@
+/*
+ * pool.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides a work-stealing thread pool for traversals,
+ * so that they use every core and stay off the thread
+ * serving http requests
+ */
+
+#include "headers.h"
+
+/*
+	Work-stealing pool
+
+	Every worker owns a Chase-Lev deque: it pushes and takes tasks at
+	the bottom without contention, while idle workers steal from the
+	top with a single compare-and-swap. A traversal splits each level
+	into chunks with pool_for, pushes them on its own deque and works
+	through them alongside whoever steals, so a level finishes as soon
+	as the slowest chunk does. Threads that aren't workers hand whole
+	jobs over through a locked queue with pool_submit. The deques
+	don't grow; a task that finds its deque full runs at once.
+*/
+
+// A unit of work: fn over [lo, hi)
+typedef struct pool_task {
+	void (*fn)(size_t lo, size_t hi, void *arg);
+	void *arg;
+	size_t lo;
+	size_t hi;
+	size_t *pending;		// pool_for's count of unfinished chunks
+	struct pool_task *next;		// in the submission queue
+	bool owned;			// allocated by pool_submit, freed after
+} pool_task;
+
+// Chase-Lev deque of one worker
+typedef struct pool_deque {
+	int64_t top;			// next to steal
+	char pad[64 - sizeof(int64_t)];
+	int64_t bottom;			// next free slot
+	pool_task *tasks[POOL_DEQUE];
+} pool_deque;
+
+static pool_deque *deques;
+static int nworkers;
+static __thread int self = -1;		// this thread's worker number
+static __thread uint64_t victim_seed;
+
+// Tasks from threads that aren't workers
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pool_task *queue_head, *queue_tail;
+
+// Idle workers sleep until the number of pushes changes
+static pthread_mutex_t idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t idle_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t pushes;
+static int sleepers;
+
+// Pushes t on the bottom of d; returns false if d is full. Owner only.
+static bool deque_push(pool_deque *d, pool_task *t) {
+	int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+	int64_t top = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+
+	if (b - top >= POOL_DEQUE) return false;
+	__atomic_store_n(&d->tasks[b & (POOL_DEQUE - 1)], t, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+// Takes the task at the bottom of d, or NULL if it's empty. Owner only.
+static pool_task *deque_take(pool_deque *d) {
+	int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1, top;
+	pool_task *t = NULL;
+
+	__atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	top = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+	if (top <= b) {
+		t = __atomic_load_n(&d->tasks[b & (POOL_DEQUE - 1)], __ATOMIC_RELAXED);
+		if (top == b) {
+			// the last task: race the thieves for it
+			if (!__atomic_compare_exchange_n(&d->top, &top, top + 1, false,
+				__ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+				t = NULL;
+			__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+		}
+	} else {
+		__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+	}
+	return t;
+}
+
+// Steals the task at the top of d, or returns NULL if it's empty or
+// another thread got there first
+static pool_task *deque_steal(pool_deque *d) {
+	int64_t top = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE), b;
+	pool_task *t;
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+	if (top >= b) return NULL;
+	t = __atomic_load_n(&d->tasks[top & (POOL_DEQUE - 1)], __ATOMIC_RELAXED);
+	if (!__atomic_compare_exchange_n(&d->top, &top, top + 1, false,
+		__ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		return NULL;
+	return t;
+}
+
+// Wakes idle workers after a push
+static void pool_wake(void) {
+	__atomic_add_fetch(&pushes, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&sleepers, __ATOMIC_SEQ_CST)) {
+		pthread_mutex_lock(&idle_lock);
+		pthread_cond_broadcast(&idle_cond);
+		pthread_mutex_unlock(&idle_lock);
+	}
+}
+
+// Returns a task from this thread's deque, another worker's, or if jobs
+// is set the submission queue, or NULL if there is none
+static pool_task *pool_find(bool jobs) {
+	pool_task *t;
+	int i;
+
+	if (self >= 0 && (t = deque_take(&deques[self]))) return t;
+	if (nworkers) {
+		// xorshift, so thieves don't all pick the same victim
+		int start;
+		victim_seed ^= victim_seed << 13;
+		victim_seed ^= victim_seed >> 7;
+		victim_seed ^= victim_seed << 17;
+		start = victim_seed % nworkers;
+		for (i = 0; i < nworkers; i++) {
+			int v = (start + i) % nworkers;
+			if (v != self && (t = deque_steal(&deques[v]))) return t;
+		}
+	}
+	if (!jobs || !__atomic_load_n(&queue_head, __ATOMIC_RELAXED)) return NULL;
+	pthread_mutex_lock(&queue_lock);
+	t = queue_head;
+	if (t) {
+		__atomic_store_n(&queue_head, t->next, __ATOMIC_RELAXED);
+		if (!queue_head) queue_tail = NULL;
+	}
+	pthread_mutex_unlock(&queue_lock);
+	return t;
+}
+
+// Runs t; a chunk of pool_for is gone once pending drops, so t isn't
+// touched after that
+static void pool_run(pool_task *t) {
+	size_t *pending = t->pending;
+	bool owned = t->owned;
+
+	t->fn(t->lo, t->hi, t->arg);
+	if (pending) __atomic_sub_fetch(pending, 1, __ATOMIC_RELEASE);
+	if (owned) free(t);
+}
+
+static void *pool_worker(void *arg) {
+	self = (int) (intptr_t) arg;
+	victim_seed = 0x9e3779b97f4a7c15ULL * (self + 1);
+
+	for (;;) {
+		uint64_t seen = __atomic_load_n(&pushes, __ATOMIC_SEQ_CST);
+		pool_task *t = pool_find(true);
+
+		if (t) {
+			pool_run(t);
+			continue;
+		}
+		// nothing to do: sleep unless something was pushed meanwhile
+		pthread_mutex_lock(&idle_lock);
+		__atomic_add_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&pushes, __ATOMIC_SEQ_CST) == seen)
+			pthread_cond_wait(&idle_cond, &idle_lock);
+		__atomic_sub_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+		pthread_mutex_unlock(&idle_lock);
+		ebr_flush();
+	}
+	return NULL;
+}
+
+// Starts n workers; with none, pool_submit and pool_for run in the caller
+void pool_init(int n) {
+	int i;
+
+	if (n <= 0) return;
+	deques = calloc(n, sizeof(pool_deque));
+	if (!deques) exit(1);
+	nworkers = n;
+	for (i = 0; i < n; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, pool_worker, (void *) (intptr_t) i)) {
+			fprintf(stderr, "Error creating thread\n");
+			exit(1);
+		}
+		pthread_detach(thread);
+	}
+}
+
+// Returns the number of workers
+int pool_size(void) {
+	return nworkers;
+}
+
+// Runs fn(0, 0, arg) on a worker and returns at once
+void pool_submit(void (*fn)(size_t, size_t, void *), void *arg) {
+	pool_task *t;
+
+	if (!nworkers) {
+		fn(0, 0, arg);
+		return;
+	}
+	t = calloc(1, sizeof(pool_task));
+	if (!t) exit(1);
+	t->fn = fn;
+	t->arg = arg;
+	t->owned = true;
+	if (self >= 0 && deque_push(&deques[self], t)) {
+		pool_wake();
+		return;
+	}
+	pthread_mutex_lock(&queue_lock);
+	if (queue_tail) queue_tail->next = t;
+	else __atomic_store_n(&queue_head, t, __ATOMIC_RELAXED);
+	queue_tail = t;
+	pthread_mutex_unlock(&queue_lock);
+	pool_wake();
+}
+
+// Runs fn(lo, hi, arg) over [0, n) in chunks of at most chunk ids, in
+// parallel when called on a worker, and returns once every chunk is done
+void pool_for(size_t n, size_t chunk, void (*fn)(size_t, size_t, void *), void *arg) {
+	size_t count = (n + chunk - 1) / chunk, pending, i;
+	pool_task *tasks;
+
+	// one chunk, or nobody to share with
+	if (count <= 1 || self < 0) {
+		if (n) fn(0, n, arg);
+		return;
+	}
+	tasks = malloc(count * sizeof(pool_task));
+	if (!tasks) exit(1);
+	pending = count;
+	// pushed last first, so the owner takes them in order
+	for (i = count; i-- > 0; ) {
+		pool_task *t = &tasks[i];
+		t->fn = fn;
+		t->arg = arg;
+		t->lo = i * chunk;
+		t->hi = t->lo + chunk < n ? t->lo + chunk : n;
+		t->pending = &pending;
+		t->owned = false;
+		if (!deque_push(&deques[self], t)) pool_run(t);
+	}
+	pool_wake();
+
+	// help out until the last chunk is done, without starting a whole
+	// new job that would hold this one up
+	while (__atomic_load_n(&pending, __ATOMIC_ACQUIRE)) {
+		pool_task *t = pool_find(false);
+		if (t) pool_run(t);
+		else sched_yield();
+	}
+	free(tasks);
+}
@@ -0,0 +1,127 @@
+/*
+ * rcache.c
+ *
+ * by Stylianos Rousoglou
+ * and Alex Saiontz
+ *
+ * Provides a bounded cache of the vertices other
+ * partitions have confirmed they have
+ */
+
+#include "headers.h"
+
+/*
+	Remote vertex cache
+
+	An edge across partitions makes this partition ask the owner of the
+	far endpoint whether it exists, and hot vertices get asked about
+	over and over. Vertices are never removed, so a yes stays true, and
+	is kept here. The cache is set-associative: an id hashes to one set
+	of RCACHE_WAYS ids, which shares a cache line with the set's
+	reference bits and clock hand. A hit sets the id's reference bit; an
+	insert into a full set sweeps the hand, clearing reference bits,
+	to the first id not referenced since it last went by, as CLOCK
+	does. Ids are stored plus one, so 0 marks a free way. Readers take
+	no lock and see either the old id of a way or the new one, both of
+	which exist; writers of a set take one of RCACHE_LOCKS locks.
+*/
+
+// The ways of one set and their CLOCK state, in one cache line
+typedef struct rcache_set {
+	uint64_t ids[RCACHE_WAYS];	// id + 1, 0 if free
+	uint32_t ref;			// bit k: way k hit since the hand passed it
+	uint32_t hand;			// next way to look at for a victim
+} __attribute__((aligned(64))) rcache_set;
+
+static struct {
+	rcache_set *sets;
+	pthread_mutex_t lock[RCACHE_LOCKS];	// writers, by set
+	uint64_t lookups;
+	uint64_t hits;
+} cache;
+
+static inline size_t set_of(uint64_t id) {
+	return hash_vertex(id) & (RCACHE_SETS - 1);
+}
+
+// Sets up the empty cache; called by init_map
+void rcache_init(void) {
+	int i;
+
+	if (!cache.sets) {
+		cache.sets = aligned_alloc(64, RCACHE_SETS * sizeof(rcache_set));
+		if (!cache.sets) exit(1);
+		for (i = 0; i < RCACHE_LOCKS; i++) pthread_mutex_init(&cache.lock[i], NULL);
+	}
+	memset(cache.sets, 0, RCACHE_SETS * sizeof(rcache_set));
+	cache.lookups = 0;
+	cache.hits = 0;
+}
+
+// Returns true if another partition confirmed it has id; needs no lock
+bool rcache_has(uint64_t id) {
+	rcache_set *s = &cache.sets[set_of(id)];
+	int k;
+
+	__atomic_add_fetch(&cache.lookups, 1, __ATOMIC_RELAXED);
+	// id + 1 would match a free way
+	if (id == UINT64_MAX) return false;
+	for (k = 0; k < RCACHE_WAYS; k++) {
+		if (__atomic_load_n(&s->ids[k], __ATOMIC_RELAXED) == id + 1) {
+			// written only once, so hits don't keep the line bouncing
+			if (!(__atomic_load_n(&s->ref, __ATOMIC_RELAXED) & 1U << k)) {
+				__atomic_or_fetch(&s->ref, 1U << k, __ATOMIC_RELAXED);
+			}
+			__atomic_add_fetch(&cache.hits, 1, __ATOMIC_RELAXED);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Records that the partition owning id confirmed it has it
+void rcache_add(uint64_t id) {
+	size_t i = set_of(id);
+	rcache_set *s = &cache.sets[i];
+	uint32_t k;
+
+	if (id == UINT64_MAX) return;
+	pthread_mutex_lock(&cache.lock[i % RCACHE_LOCKS]);
+	for (k = 0; k < RCACHE_WAYS; k++) {
+		if (s->ids[k] == id + 1) {
+			pthread_mutex_unlock(&cache.lock[i % RCACHE_LOCKS]);
+			return;
+		}
+	}
+	// a free way, or the first the hand finds unreferenced
+	for (;;) {
+		k = s->hand;
+		s->hand = (k + 1) % RCACHE_WAYS;
+		if (!s->ids[k]) break;
+		if (!(__atomic_load_n(&s->ref, __ATOMIC_RELAXED) & 1U << k)) break;
+		__atomic_and_fetch(&s->ref, ~(1U << k), __ATOMIC_RELAXED);
+	}
+	__atomic_and_fetch(&s->ref, ~(1U << k), __ATOMIC_RELAXED);
+	__atomic_store_n(&s->ids[k], id + 1, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&cache.lock[i % RCACHE_LOCKS]);
+}
+
+// Drops id, for when its partition removes it
+void rcache_forget(uint64_t id) {
+	size_t i = set_of(id);
+	rcache_set *s = &cache.sets[i];
+	int k;
+
+	if (id == UINT64_MAX) return;
+	pthread_mutex_lock(&cache.lock[i % RCACHE_LOCKS]);
+	for (k = 0; k < RCACHE_WAYS; k++) {
+		if (s->ids[k] == id + 1) __atomic_store_n(&s->ids[k], 0, __ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&cache.lock[i % RCACHE_LOCKS]);
+}
+
+// Returns the lookups made, and sets *hits to those that found the id
+uint64_t rcache_stats(uint64_t *hits) {
+	*hits = __atomic_load_n(&cache.hits, __ATOMIC_RELAXED);
+	return __atomic_load_n(&cache.lookups, __ATOMIC_RELAXED);
+}
@@ -20,9 +20,38 @@ int CHAIN_NUM;
 char * IP_1;
 char * IP_2;
 char * IP_3;
-char * NEXT_IP;
+__thread char * NEXT_IP;   // per thread, since traversals run on the pool
 char * RPC_PORT;
-pthread_mutex_t mt;
+static struct mg_mgr mgr;
+
+// Returns the rpc address of partition part
+char *partition_ip(int part) {
+  if (part == 1) return IP_1;
+  return part == 2 ? IP_2 : IP_3;
+}
+
+// Asks NEXT_IP, the partition owning id, whether it has id, unless it
+// confirmed it before or its filter rules id out; returns 200 if it
+// does, 400 if not
+static int ask_owner(uint64_t id) {
+  int said, code;
+
+  if (rcache_has(id)) return 200;
+  said = filter_lookup(id);
+  if (said == FILTER_ABSENT) return 400;
+  code = send_to_next(GET_NODE, id, 0);
+  if (code == 200) rcache_add(id);
+  else if (code == 400 && said == FILTER_MAYBE) filter_false_positive();
+  return code;
+}
+
+// Returns whether id is in the graph, asking its partition if needed
+static bool partition_has(uint64_t id) {
+  int part = id % PARTITIONS + 1;
+  if (part == CHAIN_NUM) return get_node(id);
+  NEXT_IP = partition_ip(part);
+  return ask_owner(id) == 200;
+}
 
 // Responds to given connection with code and length bytes of body
 static void respond(struct mg_connection *c, int code, const int length, const char* body) {
@@ -71,47 +100,1077 @@ char* make_json_two(const char* key1, const char* key2, int key1_length, int key
   return response;
 }
 
-// Function that returns array formatted as a C string
-char* format_neighbors(uint64_t* neighbors, int size) {
-  char* response = (char *) malloc(sizeof(char));
-  int response_length = 1;
-  response[0] = '[';
-  char dummy[20];
-  int dummy_length;
-  int i;
-  for(i = 0; i < size; i++) {
-    if (i<size-1) sprintf(dummy, "%"PRIu64",", neighbors[i]);
-    else sprintf(dummy, "%"PRIu64"", neighbors[i]);
-
-    dummy_length = strlen(dummy);
-    response_length += dummy_length;
-    response = (char *) realloc(response, sizeof(char)*(response_length + 1));
-    memcpy(response + response_length - dummy_length, dummy, dummy_length);
-    response[response_length] = '\0';
-  }
-  response_length += 2;
-  response = (char *) realloc(response, sizeof(char)*response_length);
-  response[response_length-2] = ']';
-  response[response_length-1] = '\0';
-  return response;
+// Two-digit lookup table for write_u64
+static const char digit_pairs[201] =
+  "00010203040506070809101112131415161718192021222324"
+  "25262728293031323334353637383940414243444546474849"
+  "50515253545556575859606162636465666768697071727374"
+  "75767778798081828384858687888990919293949596979899";
+
+// Returns the number of decimal digits in v
+static inline int count_digits(uint64_t v) {
+  int n = 1;
+  for (;;) {
+    if (v < 10) return n;
+    if (v < 100) return n + 1;
+    if (v < 1000) return n + 2;
+    if (v < 10000) return n + 3;
+    v /= 10000;
+    n += 4;
+  }
 }
 
-// Returns allocated string in json format, formatted for get_neighbors
-char* make_neighbor_response(const char* key1, const char* key2, int key1_length, int key2_length, int value1, char* neighbors) {
-  char dummy[20];
-  sprintf(dummy, "%d", value1);
-  int value1_length = strlen(dummy);
+// Writes v's n digits ending just before end, two at a time
+static inline void write_u64(char *end, uint64_t v) {
+  while (v >= 100) {
+    int pair = (v % 100) * 2;
+    v /= 100;
+    *--end = digit_pairs[pair + 1];
+    *--end = digit_pairs[pair];
+  }
+  if (v >= 10) {
+    *--end = digit_pairs[v * 2 + 1];
+    *--end = digit_pairs[v * 2];
+  } else {
+    *--end = '0' + v;
+  }
+}
 
-  int response_length = 9 + key1_length + value1_length + key2_length + strlen(neighbors) + 1;
-  char* response = (char *) malloc(sizeof(char) * response_length);
-  sprintf(response, "{\"%s\":%d,\"%s\":%s}", key1, value1, key2, neighbors);
-  return response;
+static const char neighbors_prefix[] = "{\"node_id\":";
+static const char neighbors_middle[] = ",\"neighbors\":[";
+
+// Returns the length of a neighbors body for id with n neighbors whose
+// digits add up to digits
+static inline size_t neighbors_length(uint64_t id, size_t n, size_t digits) {
+  // every id but the last is followed by a comma
+  return sizeof(neighbors_prefix) - 1 + count_digits(id)
+    + sizeof(neighbors_middle) - 1 + digits + (n ? n - 1 : 0) + 2;
+}
+
+// Sends the headers for a length-byte neighbors body, reserves the body
+// in the send buffer and writes its opening; returns where the ids go
+static char *begin_neighbors(struct mg_connection *c, uint64_t id, size_t length) {
+  struct mbuf *out = &c->send_mbuf;
+  char *p;
+
+  mg_send_head(c, 200, length, "Content-Type: application/json");
+  mbuf_resize(out, out->len + length);
+  p = out->buf + out->len;
+  memcpy(p, neighbors_prefix, sizeof(neighbors_prefix) - 1);
+  p += sizeof(neighbors_prefix) - 1;
+  p += count_digits(id);
+  write_u64(p, id);
+  memcpy(p, neighbors_middle, sizeof(neighbors_middle) - 1);
+  return p + sizeof(neighbors_middle) - 1;
+}
+
+// Responds with vertex i of an up-to-date snapshot; the ranges never
+// change, so there is nothing to retry
+static void send_csr_neighbors(struct mg_connection *c, const csr_snapshot *s, size_t i) {
+  struct mbuf *out = &c->send_mbuf;
+  uint64_t id = s->ids[i], k, lo = s->offsets[i], hi = s->offsets[i + 1];
+  size_t digits = 0, length;
+  char *p;
+
+  for (k = lo; k < hi; k++) digits += count_digits(s->ids[s->neighbors[k]]);
+  length = neighbors_length(id, hi - lo, digits);
+  p = begin_neighbors(c, id, length);
+  for (k = lo; k < hi; k++) {
+    uint64_t n = s->ids[s->neighbors[k]];
+    if (k > lo) *p++ = ',';
+    p += count_digits(n);
+    write_u64(p, n);
+  }
+  *p++ = ']';
+  *p++ = '}';
+  out->len += length;
+}
+
+// Returns the id of local index n, or 0 for one a racing writer has
+// reclaimed; the read that saw it is retried
+static inline uint64_t neighbor_id(uint32_t n) {
+  vertex *w = vertex_at(n);
+  return w ? w->id : 0;
+}
+
+// Responds with the neighbors of vertex id, or 400 if it doesn't exist.
+// Copies the list's local indices, sizes the body in one pass over them,
+// then writes each one's id straight into the connection's send buffer;
+// if a writer changed the list in the meantime, the response is dropped
+// from the buffer and built again. An unchanged graph is served from
+// the CSR snapshot.
+static void send_neighbors(struct mg_connection *c, uint64_t id) {
+  static uint32_t *idx;  // poll thread only, kept for the next request
+  static uint32_t cap;
+  struct mbuf *out = &c->send_mbuf;
+  size_t start = out->len;
+  csr_snapshot *s;
+  vertex *v;
+  adj_list l;
+  uint32_t seq, i;
+  bool fits;
+
+  ebr_enter();
+  if ((s = csr_fresh())) {
+    int64_t n = csr_find(s, id);
+    if (n < 0) badRequest(c);
+    else send_csr_neighbors(c, s, n);
+    ebr_exit();
+    return;
+  }
+  v = ret_vertex(id);
+  if (!v) {
+    ebr_exit();
+    badRequest(c);
+    return;
+  }
+  do {
+    out->len = start;
+    seq = adj_snapshot(v, &l);
+    if (l.n > cap) {
+      free(idx);
+      cap = l.n;
+      idx = (uint32_t *) malloc(cap * sizeof(uint32_t));
+      if (!idx) exit(1);
+    }
+    adj_copy(&l, idx);
+
+    size_t total = 0;
+    for (i = 0; i < l.n; i++) total += count_digits(neighbor_id(idx[i]));
+    size_t length = neighbors_length(id, l.n, total);
+
+    char *p = begin_neighbors(c, id, length);
+    for (i = 0, fits = true; i < l.n; i++) {
+      uint64_t n = neighbor_id(idx[i]);
+      size_t digits = count_digits(n);
+      // a racing writer may have changed an id since it was counted
+      if (digits > total) {
+        fits = false;
+        break;
+      }
+      total -= digits;
+      if (i) *p++ = ',';
+      p += digits;
+      write_u64(p, n);
+    }
+    *p++ = ']';
+    *p++ = '}';
+    out->len += length;
+  } while (!fits || !read_valid(v, seq));
+  ebr_exit();
+}
+
+static const char neighbors_next[] = ",\"next\":";
+
+// Responds with up to limit neighbors of id in ascending id order, those
+// above after if has_after is set, and with a next cursor if more
+// follow; 400 if id doesn't exist
+static void send_neighbor_page(struct mg_connection *c, uint64_t id, bool has_after,
+  uint64_t after, uint32_t limit) {
+  struct mbuf *out = &c->send_mbuf;
+  uint64_t *ids = (uint64_t *) malloc((limit + 1) * sizeof(uint64_t));
+  size_t digits = 0, length;
+  int64_t n, k;
+  bool more;
+  char *p;
+
+  if (!ids) exit(1);
+  // one past the page tells whether there is more
+  n = get_neighbor_page(id, has_after ? &after : NULL, limit + 1, ids);
+  if (n < 0) {
+    free(ids);
+    badRequest(c);
+    return;
+  }
+  more = n > limit;
+  if (more) n = limit;
+  for (k = 0; k < n; k++) digits += count_digits(ids[k]);
+  length = neighbors_length(id, n, digits);
+  if (more) length += sizeof(neighbors_next) - 1 + count_digits(ids[n - 1]);
+
+  p = begin_neighbors(c, id, length);
+  for (k = 0; k < n; k++) {
+    if (k) *p++ = ',';
+    p += count_digits(ids[k]);
+    write_u64(p, ids[k]);
+  }
+  *p++ = ']';
+  if (more) {
+    memcpy(p, neighbors_next, sizeof(neighbors_next) - 1);
+    p += sizeof(neighbors_next) - 1;
+    p += count_digits(ids[n - 1]);
+    write_u64(p, ids[n - 1]);
+  }
+  *p++ = '}';
+  out->len += length;
+  free(ids);
+}
+
+/*
+  A streamed neighbor list goes out with chunked encoding,
+  NEIGHBORS_CHUNK ids at a time, whenever the connection's send buffer
+  has drained below NEIGHBORS_LOW, so a supernode's reply never sits in
+  memory whole. It goes out in ascending id order, like pages do, from
+  a copy of the list sorted once at the start; the copy comes from the
+  CSR snapshot if that is up to date and is otherwise made under the
+  list's sequence lock. Either way the client gets one consistent list,
+  and nothing is locked while it goes out.
+*/
+
+// Marks a connection whose user_data is a neighbor stream
+#define STREAMING MG_F_USER_2
+
+// A neighbor list being streamed
+typedef struct neighbor_stream {
+  uint64_t *ids;          // the copied neighbors, sorted
+  size_t pos;             // neighbors sent
+  size_t n;
+} neighbor_stream;
+
+static int cmp_u64(const void *x, const void *y) {
+  uint64_t a = *(const uint64_t *) x, b = *(const uint64_t *) y;
+  return a < b ? -1 : a > b;
+}
+
+// Lets go of c's stream
+static void end_stream(struct mg_connection *c) {
+  neighbor_stream *st = (neighbor_stream *) c->user_data;
+
+  free(st->ids);
+  free(st);
+  c->user_data = NULL;
+  c->flags &= ~STREAMING;
+}
+
+// Writes chunks of c's stream until its send buffer fills up or the
+// list ends
+static void pump_stream(struct mg_connection *c) {
+  neighbor_stream *st = (neighbor_stream *) c->user_data;
+  // up to 20 digits and a comma per id, and the closing "]}"
+  static char chunk[NEIGHBORS_CHUNK * 21 + 2];  // poll thread only
+
+  while (c->send_mbuf.len < NEIGHBORS_LOW) {
+    size_t end = st->n - st->pos < NEIGHBORS_CHUNK ? st->n : st->pos + NEIGHBORS_CHUNK;
+    char *p = chunk;
+
+    for (; st->pos < end; st->pos++) {
+      uint64_t n = st->ids[st->pos];
+      if (st->pos) *p++ = ',';
+      p += count_digits(n);
+      write_u64(p, n);
+    }
+    if (st->pos == st->n) {
+      *p++ = ']';
+      *p++ = '}';
+      mg_send_http_chunk(c, chunk, p - chunk);
+      mg_send_http_chunk(c, "", 0);
+      end_stream(c);
+      return;
+    }
+    mg_send_http_chunk(c, chunk, p - chunk);
+  }
+}
+
+// Starts streaming the neighbors of id to c, or answers 400 if id
+// doesn't exist
+static void begin_stream(struct mg_connection *c, uint64_t id) {
+  neighbor_stream *st;
+  char head[64];
+  int n;
+
+  if (!get_node(id)) {
+    badRequest(c);
+    return;
+  }
+  st = (neighbor_stream *) calloc(1, sizeof(neighbor_stream));
+  if (!st) exit(1);
+  st->ids = get_neighbors(id, &n);
+  st->n = n;
+  if (st->n > 1) qsort(st->ids, st->n, sizeof(uint64_t), cmp_u64);
+  c->user_data = st;
+  c->flags |= STREAMING;
+
+  mg_send_head(c, 200, -1, "Content-Type: application/json");
+  n = snprintf(head, sizeof(head), "%s%" PRIu64 "%s", neighbors_prefix, id, neighbors_middle);
+  mg_send_http_chunk(c, head, n);
+  pump_stream(c);
+}
+
+// Responds with the degree of vertex id, or 400 if it doesn't exist
+static void send_degree(struct mg_connection *c, uint64_t id) {
+  char body[64];
+  int64_t d = get_degree(id);
+
+  if (d < 0) {
+    badRequest(c);
+    return;
+  }
+  respond(c, 200, snprintf(body, sizeof(body),
+    "{\"node_id\":%" PRIu64 ",\"degree\":%" PRId64 "}", id, d), body);
+}
+
+static const char degrees_prefix[] = "{\"degrees\":[";
+
+// Responds with the degrees of the ids in the array token t, -1 for
+// those that don't exist, or 400 if t isn't an array of up to BATCH_MAX
+// numbers
+static void send_degrees(struct mg_connection *c, const struct json_token *t) {
+  const struct json_token *e, *end;
+  uint64_t *ids;
+  int64_t *degrees;
+  size_t i, n = 0, length = sizeof(degrees_prefix) - 1 + 2;
+  char *p;
+
+  if (!t || t->type != JSON_TYPE_ARRAY) {
+    badRequest(c);
+    return;
+  }
+  end = t + 1 + t->num_desc;
+  for (e = t + 1; e < end; e += 1 + e->num_desc) {
+    if (e->type != JSON_TYPE_NUMBER || ++n > BATCH_MAX) {
+      badRequest(c);
+      return;
+    }
+  }
+  ids = (uint64_t *) malloc((n + 1) * sizeof(uint64_t));
+  degrees = (int64_t *) malloc((n + 1) * sizeof(int64_t));
+  if (!ids || !degrees) exit(1);
+  for (i = 0, e = t + 1; e < end; e += 1 + e->num_desc) ids[i++] = strtoull(e->ptr, NULL, 10);
+  get_degrees(ids, n, degrees);
+
+  // a missing vertex is written as -1
+  for (i = 0; i < n; i++) length += (degrees[i] < 0 ? 2 : count_digits(degrees[i])) + (i ? 1 : 0);
+  mg_send_head(c, 200, length, "Content-Type: application/json");
+  mbuf_resize(&c->send_mbuf, c->send_mbuf.len + length);
+  p = c->send_mbuf.buf + c->send_mbuf.len;
+  memcpy(p, degrees_prefix, sizeof(degrees_prefix) - 1);
+  p += sizeof(degrees_prefix) - 1;
+  for (i = 0; i < n; i++) {
+    if (i) *p++ = ',';
+    if (degrees[i] < 0) {
+      *p++ = '-';
+      *p++ = '1';
+      continue;
+    }
+    p += count_digits(degrees[i]);
+    write_u64(p, degrees[i]);
+  }
+  *p++ = ']';
+  *p++ = '}';
+  c->send_mbuf.len += length;
+  free(ids);
+  free(degrees);
+}
+
+// Responds with the store's counters
+static void respond_stats(struct mg_connection *c) {
+  char response[1024];
+  uint64_t csr_ms, csr_version = csr_stats(&csr_ms);
+  uint64_t path_levels, path_bytes, paths = path_stats(&path_levels, &path_bytes);
+  uint64_t negatives, false_positives, lookups = filter_stats(&negatives, &false_positives);
+  uint64_t cache_hits, cache_lookups = rcache_stats(&cache_hits);
+  int length = snprintf(response, sizeof(response),
+    "{\"nodes\":%zu,\"ghosts\":%zu,\"ghosts_reclaimed\":%zu,\"indices_reused\":%zu,"
+    "\"exist_bytes\":%zu,\"edges\":%zu,\"hubs\":%zu,"
+    "\"hub_promotions\":%zu,\"hub_demotions\":%zu,\"slabs\":%zu,"
+    "\"adj_bytes\":%zu,\"bytes_per_edge\":%.2f,"
+    "\"version\":%" PRIu64 ",\"csr_version\":%" PRIu64 ",\"csr_build_ms\":%" PRIu64 ","
+    "\"paths\":%" PRIu64 ",\"path_levels\":%" PRIu64 ",\"path_bytes\":%" PRIu64 ","
+    "\"filter_lookups\":%" PRIu64 ",\"filter_negatives\":%" PRIu64 ","
+    "\"filter_false_positives\":%" PRIu64 ",\"filter_fp_rate\":%.6f,"
+    "\"rcache_lookups\":%" PRIu64 ",\"rcache_hits\":%" PRIu64 ",\"rcache_hit_ratio\":%.4f,"
+    "\"rpcs_saved\":%" PRIu64 "}",
+    map.nsize, map.ghosts, map.reclaimed, map.reused, exist_bytes(), map.esize, map.hubs, map.promotions, map.demotions,
+    slab_count(), map.adj_bytes,
+    map.esize ? (double) map.adj_bytes / map.esize : 0.0,
+    map.version, csr_version, csr_ms, paths, path_levels, path_bytes,
+    lookups, negatives, false_positives,
+    // of the ids missing over there, those the filter let through
+    negatives + false_positives ? (double) false_positives / (negatives + false_positives) : 0.0,
+    cache_lookups, cache_hits, cache_lookups ? (double) cache_hits / cache_lookups : 0.0,
+    // GET_NODE round trips answered here instead
+    cache_hits + negatives);
+  respond(c, 200, length, response);
+}
+
+/*
+  Traversals run on the pool, so the poll thread goes on serving other
+  requests meanwhile; so does add_node, whose acknowledgement may wait
+  for the filter thread to reach every peer. The connection is tagged through its user_data,
+  and the finished job passes its reply back with mg_broadcast, whose
+  callback runs on the poll thread and only answers the connection
+  with the matching tag: if the client went away, nobody does.
+*/
+
+// Reply of a traversal, copied to the poll thread
+typedef struct traversal_reply {
+  struct mg_connection *c;
+  void *tag;
+  int code;
+  int length;
+  char body[192];
+} traversal_reply;
+
+// A traversal handed to the pool
+typedef struct traversal {
+  traversal_reply reply;
+  uint64_t a;
+  uint64_t b;
+} traversal;
+
+static uintptr_t last_tag;  // poll thread only
+
+// mg_broadcast callback: answers the connection the reply is for
+static void deliver(struct mg_connection *c, int ev, void *p) {
+  traversal_reply *r = (traversal_reply *) p;
+  if (c != r->c || c->user_data != r->tag) return;
+  c->user_data = NULL;
+  respond(c, r->code, r->length, r->body);
+}
+
+// Returns a traversal that will answer c
+static traversal *begin_traversal(struct mg_connection *c, uint64_t a, uint64_t b) {
+  traversal *t = (traversal *) calloc(1, sizeof(traversal));
+  if (!t) exit(1);
+  c->user_data = (void *) ++last_tag;
+  t->reply.c = c;
+  t->reply.tag = c->user_data;
+  t->a = a;
+  t->b = b;
+  return t;
+}
+
+// Sends t's reply from whichever thread ran it, and frees t
+static void end_traversal(traversal *t, int code, int length) {
+  t->reply.code = code;
+  t->reply.length = length;
+  // without workers the job ran right here on the poll thread
+  if (pool_size()) mg_broadcast(&mgr, deliver, &t->reply, sizeof(traversal_reply));
+  else deliver(t->reply.c, MG_EV_POLL, &t->reply);
+  free(t);
+}
+
+// Pool job: shortest path between t->a and t->b
+static void run_shortest_path(size_t lo, size_t hi, void *arg) {
+  traversal *t = (traversal *) arg;
+  uint32_t levels;
+  uint64_t bytes;
+  int distance;
+
+  if (!partition_has(t->a) || !partition_has(t->b)) {
+    end_traversal(t, 400, 0);
+    return;
+  }
+  distance = distributed_path(t->a, t->b, &levels, &bytes);
+  if (distance == -2) {
+    // a partition didn't answer
+    end_traversal(t, 500, 0);
+  } else if (distance < 0) {
+    // no path between the two
+    end_traversal(t, 204, 0);
+  } else {
+    end_traversal(t, 200, snprintf(t->reply.body, sizeof(t->reply.body),
+      "{\"distance\":%d,\"levels\":%" PRIu32 ",\"bytes\":%" PRIu64 "}",
+      distance, levels, bytes));
+  }
+}
+
+// Pool job: BFS from t->a
+static void run_bfs(size_t lo, size_t hi, void *arg) {
+  traversal *t = (traversal *) arg;
+  bfs_result r;
+
+  if (!bfs_from(t->a, &r)) {
+    end_traversal(t, 400, 0);
+    return;
+  }
+  end_traversal(t, 200, snprintf(t->reply.body, sizeof(t->reply.body),
+    "{\"node_id\":%" PRIu64 ",\"reached\":%" PRIu64 ",\"levels\":%" PRIu32
+    ",\"bottom_up\":%" PRIu32 ",\"edges\":%" PRIu64 ",\"stale\":%s}",
+    t->a, r.reached, r.levels, r.bottom_up, r.edges, r.stale ? "true" : "false"));
+}
+
+// Pool job: adds vertex t->a and acknowledges it once no peer's filter
+// can turn it away
+static void run_add_node(size_t lo, size_t hi, void *arg) {
+  traversal *t = (traversal *) arg;
+  char *response;
+  bool added;
+
+  lock_node(t->a, true);
+  added = add_vertex(t->a);
+  unlock_node(t->a);
+  filter_sync();
+  if (!added) {
+    // vertex already existed
+    end_traversal(t, 204, 0);
+    return;
+  }
+  response = make_json_one("node_id", 7, t->a);
+  end_traversal(t, 200, snprintf(t->reply.body, sizeof(t->reply.body), "%s", response));
+  free(response);
+}
+
+/*
+  Bulk loads are sent chunked: each chunk is moved out of the
+  connection into its loader, which hands the pool LOAD_BATCH bytes at
+  a time, cut at a line (or pair) boundary. A loader is only touched on
+  the poll thread; finished batches come back through mg_broadcast.
+  Once LOAD_INFLIGHT batches are queued the connection stops reading
+  until one is done, so a fast client can't outrun the pool.
+*/
+
+// Marks a connection whose user_data is its loader
+#define BULK_LOADING MG_F_USER_1
+
+// A bulk load in progress
+typedef struct loader {
+  struct mg_connection *c;  // NULL once the client is gone
+  bool binary;              // pairs of 64-bit ids rather than text
+  bool ended;               // the whole stream has arrived
+  char *buf;                // bytes not handed to a batch yet
+  size_t len;
+  size_t cap;
+  int inflight;             // batches on the pool
+  bool overlong;            // a line didn't fit in a batch: the load gets 400
+  load_result result;
+} loader;
+
+// A part of the stream handed to the pool
+typedef struct bulk_batch {
+  loader *l;
+  char *buf;
+  size_t len;
+  load_result result;
+} bulk_batch;
+
+// Returns a loader for the bulk load arriving on c
+static loader *begin_load(struct mg_connection *c, struct http_message *hm) {
+  loader *l = (loader *) calloc(1, sizeof(loader));
+  struct mg_str *type = mg_get_http_header(hm, "Content-Type");
+  if (!l) exit(1);
+  l->c = c;
+  l->binary = type && !mg_vcasecmp(type, "application/octet-stream");
+  c->user_data = l;
+  c->flags |= BULK_LOADING;
+  return l;
+}
+
+// Answers and frees l once its stream has ended and every batch is done
+static void end_load(loader *l) {
+  if (!l->ended || l->inflight) return;
+  if (l->c) {
+    char body[192];
+    int length = snprintf(body, sizeof(body),
+      "{\"edges\":%" PRIu64 ",\"added\":%" PRIu64 ",\"shipped\":%" PRIu64 ",\"bad\":%" PRIu64 "}",
+      l->result.edges, l->result.added, l->result.shipped, l->result.bad);
+    l->c->user_data = NULL;
+    l->c->flags &= ~BULK_LOADING;
+    // a partition that didn't answer is missing some of the edges
+    if (l->overlong) respond(l->c, 400, 0, "");
+    else respond(l->c, l->result.failed ? 500 : 200, length, body);
+  }
+  free(l->buf);
+  free(l);
+}
+
+// Poll thread: adds up a finished batch and lets its stream go on
+static void batch_done(bulk_batch *b) {
+  loader *l = b->l;
+
+  l->inflight--;
+  l->result.edges += b->result.edges;
+  l->result.added += b->result.added;
+  l->result.shipped += b->result.shipped;
+  l->result.bad += b->result.bad;
+  l->result.failed |= b->result.failed;
+  free(b->buf);
+  free(b);
+  if (l->c && !l->ended && l->inflight < LOAD_INFLIGHT) l->c->recv_mbuf_limit = ~0;
+  end_load(l);
+}
+
+// mg_broadcast callback: runs batch_done once, on the first connection
+static void load_done(struct mg_connection *c, int ev, void *p) {
+  if (c != mg_next(c->mgr, NULL)) return;
+  batch_done(*(bulk_batch **) p);
+}
+
+// Pool job: loads a batch
+static void run_load(size_t lo, size_t hi, void *arg) {
+  bulk_batch *b = (bulk_batch *) arg;
+
+  load_batch(b->buf, b->len, b->l->binary, &b->result);
+  // without workers the job ran right here on the poll thread
+  if (pool_size()) mg_broadcast(&mgr, load_done, &b, sizeof(b));
+  else batch_done(b);
+}
+
+// Hands the first n buffered bytes of l to the pool
+static void submit_batch(loader *l, size_t n) {
+  bulk_batch *b = (bulk_batch *) calloc(1, sizeof(bulk_batch));
+  if (!b) exit(1);
+  b->l = l;
+  b->buf = l->buf;
+  b->len = n;
+  l->cap = l->len - n > LOAD_BATCH ? l->len - n : LOAD_BATCH;
+  l->buf = (char *) malloc(l->cap);
+  if (!l->buf) exit(1);
+  memcpy(l->buf, b->buf + n, l->len - n);
+  l->len -= n;
+  l->inflight++;
+  pool_submit(run_load, b);
+}
+
+// Buffers n more bytes of l's stream and sends off whole batches; at the
+// end of the stream, sends off the rest
+static void feed_load(loader *l, const char *p, size_t n, bool last) {
+  // the rest of a stream that is turned away is dropped as it comes
+  if (l->overlong) return;
+  if (l->len + n > l->cap) {
+    while (l->len + n > l->cap) l->cap = l->cap ? l->cap * 2 : LOAD_BATCH;
+    l->buf = (char *) realloc(l->buf, l->cap);
+    if (!l->buf) exit(1);
+  }
+  memcpy(l->buf + l->len, p, n);
+  l->len += n;
+
+  while (l->len >= LOAD_BATCH) {
+    size_t cut = l->len;
+    if (l->binary) {
+      cut -= cut % (2 * sizeof(uint64_t));
+    } else {
+      // up to the last whole line; a line longer than a batch can't
+      // be cut without making up an edge, so the load is turned away
+      while (cut && l->buf[cut - 1] != '\n') cut--;
+      if (!cut) {
+        l->overlong = true;
+        l->len = 0;
+        return;
+      }
+    }
+    submit_batch(l, cut);
+  }
+  if (last && l->len) submit_batch(l, l->len);
+  if (l->c && !last && l->inflight >= LOAD_INFLIGHT) l->c->recv_mbuf_limit = 0;
+}
+
+/*
+  A batch is parsed on the poll thread and applied on the pool, like a
+  traversal. Its reply can be of any size, so it comes back to the poll
+  thread as a pointer, through a broadcast that runs once and looks
+  for the connection itself, so the body is freed even if the client
+  went away.
+*/
+
+static const char batch_prefix[] = "{\"results\":[";
+static const char batch_middle[] = "],\"neighbors\":[";
+
+// Reply of a batch or a k-hop query, passed to the poll thread
+typedef struct batch_reply {
+  struct mg_connection *c;
+  void *tag;
+  int code;
+  char *body;
+  size_t length;
+} batch_reply;
+
+// A batch handed to the pool
+typedef struct batch_job {
+  batch_reply reply;
+  batch_op *ops;
+  size_t n;
+} batch_job;
+
+// Returns whether token t is the string s
+static bool token_is(const struct json_token *t, const char *s) {
+  return t->len == (int) strlen(s) && !strncmp(t->ptr, s, t->len);
+}
+
+// Fills o from an op object {"op":"add_edge","node_a_id":1,"node_b_id":2};
+// an op that is unknown or misses its ids gets BAD_OP
+static void parse_op(const struct json_token *t, batch_op *o) {
+  const struct json_token *k, *end = t + 1 + t->num_desc;
+  bool has_a = false, has_b = false;
+
+  o->op = BAD_OP;
+  if (t->type != JSON_TYPE_OBJECT) return;
+  for (k = t + 1; k < end; k += 2 + k[1].num_desc) {
+    const struct json_token *v = k + 1;
+    if (token_is(k, "op") && v->type == JSON_TYPE_STRING) {
+      if (token_is(v, "add_node")) o->op = ADD_NODE;
+      else if (token_is(v, "add_edge")) o->op = ADD_EDGE;
+      else if (token_is(v, "remove_edge")) o->op = REMOVE_EDGE;
+      else if (token_is(v, "get_node")) o->op = GET_NODE;
+      else if (token_is(v, "get_edge")) o->op = GET_EDGE;
+      else if (token_is(v, "get_neighbors")) o->op = GET_NEIGHBORS;
+    } else if (v->type == JSON_TYPE_NUMBER) {
+      if (token_is(k, "node_id") || token_is(k, "node_a_id")) {
+        o->a = strtoull(v->ptr, NULL, 10);
+        has_a = true;
+      } else if (token_is(k, "node_b_id")) {
+        o->b = strtoull(v->ptr, NULL, 10);
+        has_b = true;
+      }
+    }
+  }
+  if (!has_a || (!has_b && (o->op == ADD_EDGE || o->op == REMOVE_EDGE || o->op == GET_EDGE))) {
+    o->op = BAD_OP;
+  }
+}
+
+// Returns the ops of a batch body {"ops":[...]}, or NULL if it isn't one
+static batch_op *parse_batch(const char *body, size_t len, size_t *n) {
+  struct json_token *tokens = parse_json2(body, len), *ops, *t, *end;
+  batch_op *out = NULL;
+  size_t i = 0;
+
+  ops = tokens ? find_json_token(tokens, "ops") : NULL;
+  if (ops && ops->type == JSON_TYPE_ARRAY) {
+    end = ops + 1 + ops->num_desc;
+    for (*n = 0, t = ops + 1; t < end; t += 1 + t->num_desc) (*n)++;
+    if (*n && *n <= BATCH_MAX) {
+      out = (batch_op *) calloc(*n, sizeof(batch_op));
+      if (!out) exit(1);
+      for (t = ops + 1; t < end; t += 1 + t->num_desc) parse_op(t, &out[i++]);
+    }
+  }
+  free(tokens);
+  return out;
+}
+
+// Returns the reply body of a batch, the codes in order and then one
+// neighbor list per get_neighbors op; *length gets its length
+static char *batch_body(const batch_op *ops, size_t n, size_t *length) {
+  size_t i, lists = 0, len = sizeof(batch_prefix) - 1 + sizeof(batch_middle) - 1 + 2;
+  char *body, *p;
+  int k;
+
+  for (i = 0; i < n; i++) {
+    len += count_digits(ops[i].code) + (i ? 1 : 0);
+    if (ops[i].op != GET_NEIGHBORS) continue;
+    // brackets, and a comma before all but the first list
+    len += 2 + (lists++ ? 1 : 0);
+    for (k = 0; k < ops[i].n; k++) len += count_digits(ops[i].neighbors[k]) + (k ? 1 : 0);
+  }
+  body = p = (char *) malloc(len);
+  if (!body) exit(1);
+  memcpy(p, batch_prefix, sizeof(batch_prefix) - 1);
+  p += sizeof(batch_prefix) - 1;
+  for (i = 0; i < n; i++) {
+    if (i) *p++ = ',';
+    p += count_digits(ops[i].code);
+    write_u64(p, ops[i].code);
+  }
+  memcpy(p, batch_middle, sizeof(batch_middle) - 1);
+  p += sizeof(batch_middle) - 1;
+  for (i = 0, lists = 0; i < n; i++) {
+    if (ops[i].op != GET_NEIGHBORS) continue;
+    if (lists++) *p++ = ',';
+    *p++ = '[';
+    for (k = 0; k < ops[i].n; k++) {
+      if (k) *p++ = ',';
+      p += count_digits(ops[i].neighbors[k]);
+      write_u64(p, ops[i].neighbors[k]);
+    }
+    *p++ = ']';
+  }
+  *p++ = ']';
+  *p++ = '}';
+  *length = len;
+  return body;
+}
+
+// mg_broadcast callback: runs once, on the first connection, answers
+// the connection the reply is for if it is still there, and frees it
+static void deliver_batch(struct mg_connection *c, int ev, void *p) {
+  batch_reply *r = (batch_reply *) p;
+  struct mg_connection *nc;
+
+  if (c != mg_next(c->mgr, NULL)) return;
+  for (nc = c; nc; nc = mg_next(c->mgr, nc)) {
+    if (nc != r->c || nc->user_data != r->tag) continue;
+    nc->user_data = NULL;
+    mg_send_head(nc, r->code, r->length, "Content-Type: application/json");
+    mg_send(nc, r->body, r->length);
+  }
+  free(r->body);
+}
+
+// Passes r to the poll thread, which answers and frees its body
+static void send_reply(batch_reply *r) {
+  // without workers the job ran right here on the poll thread
+  if (pool_size()) mg_broadcast(&mgr, deliver_batch, r, sizeof(batch_reply));
+  else deliver_batch(mg_next(&mgr, NULL), MG_EV_POLL, r);
+}
+
+// Pool job: applies a batch and sends its reply to the poll thread
+static void run_batch(size_t lo, size_t hi, void *arg) {
+  batch_job *j = (batch_job *) arg;
+  size_t i;
+
+  apply_batch(j->ops, j->n);
+  j->reply.code = 200;
+  j->reply.body = batch_body(j->ops, j->n, &j->reply.length);
+  for (i = 0; i < j->n; i++) free(j->ops[i].neighbors);
+  free(j->ops);
+  send_reply(&j->reply);
+  free(j);
+}
+
+// Parses the batch in hm's body and hands it to the pool, or answers 400
+static void begin_batch(struct mg_connection *c, struct http_message *hm) {
+  batch_job *j;
+  size_t n;
+  batch_op *ops = parse_batch(hm->body.p, hm->body.len, &n);
+
+  if (!ops) {
+    badRequest(c);
+    return;
+  }
+  j = (batch_job *) calloc(1, sizeof(batch_job));
+  if (!j) exit(1);
+  c->user_data = (void *) ++last_tag;
+  j->reply.c = c;
+  j->reply.tag = c->user_data;
+  j->ops = ops;
+  j->n = n;
+  pool_submit(run_batch, j);
+}
+
+/*
+  A k-hop query runs on the pool and answers like a batch, since a
+  reply with the ids in it can be of any size.
+*/
+
+// A k-hop query handed to the pool
+typedef struct khop_job {
+  batch_reply reply;
+  uint64_t id;
+  uint32_t k;
+  uint64_t limit;
+  bool ids;
+} khop_job;
+
+// Returns the reply body of a k-hop query; *length gets its length
+static char *khop_body(uint64_t id, uint32_t k, const khop_result *r, size_t *length) {
+  char head[160], *body, *p;
+  uint32_t i;
+  size_t len;
+  uint64_t j;
+  int n = snprintf(head, sizeof(head),
+    "{\"node_id\":%" PRIu64 ",\"k\":%" PRIu32 ",\"count\":%" PRIu64
+    ",\"truncated\":%s,\"bytes\":%" PRIu64 ",\"levels\":[",
+    id, k, r->count, r->truncated ? "true" : "false", r->bytes);
+
+  // the head, each level's count, and "],\"ids\":[" ... "]" or "]"
+  len = n + 1 + 1;
+  for (i = 0; i < r->levels; i++) len += count_digits(r->level[i]) + (i ? 1 : 0);
+  if (r->ids) {
+    len += 8 + 1;
+    for (j = 0; j < r->count; j++) len += count_digits(r->ids[j]) + (j ? 1 : 0);
+  }
+  body = p = (char *) malloc(len);
+  if (!body) exit(1);
+  memcpy(p, head, n);
+  p += n;
+  for (i = 0; i < r->levels; i++) {
+    if (i) *p++ = ',';
+    p += count_digits(r->level[i]);
+    write_u64(p, r->level[i]);
+  }
+  *p++ = ']';
+  if (r->ids) {
+    memcpy(p, ",\"ids\":[", 8);
+    p += 8;
+    for (j = 0; j < r->count; j++) {
+      if (j) *p++ = ',';
+      p += count_digits(r->ids[j]);
+      write_u64(p, r->ids[j]);
+    }
+    *p++ = ']';
+  }
+  *p++ = '}';
+  *length = len;
+  return body;
+}
+
+// Pool job: k-hop neighborhood of j->id
+static void run_k_hop(size_t lo, size_t hi, void *arg) {
+  khop_job *j = (khop_job *) arg;
+  khop_result r;
+
+  if (!partition_has(j->id)) {
+    j->reply.code = 400;
+  } else if (distributed_khop(j->id, j->k, j->limit, j->ids, &r) < 0) {
+    // a partition didn't answer
+    j->reply.code = 500;
+  } else {
+    j->reply.code = 200;
+    j->reply.body = khop_body(j->id, j->k, &r, &j->reply.length);
+    free(r.ids);
+  }
+  send_reply(&j->reply);
+  free(j);
+}
+
+// Hands a k-hop query from id to the pool
+static void begin_k_hop(struct mg_connection *c, uint64_t id, uint32_t k, uint64_t limit, bool ids) {
+  khop_job *j = (khop_job *) calloc(1, sizeof(khop_job));
+  if (!j) exit(1);
+  c->user_data = (void *) ++last_tag;
+  j->reply.c = c;
+  j->reply.tag = c->user_data;
+  j->id = id;
+  j->k = k;
+  j->limit = limit;
+  j->ids = ids;
+  pool_submit(run_k_hop, j);
+}
+
+/*
+  Common neighbor and triangle queries may need other partitions'
+  lists, so they run on the pool too and answer like a batch.
+*/
+
+// A common neighbors (a and b) or triangle (a) query handed to the pool
+typedef struct isect_job {
+  batch_reply reply;
+  uint64_t a;
+  uint64_t b;
+  bool ids;
+} isect_job;
+
+// Pool job: common neighbors of j->a and j->b, with their Jaccard
+// similarity, and the ids if asked for
+static void run_common_neighbors(size_t lo, size_t hi, void *arg) {
+  isect_job *j = (isect_job *) arg;
+  uint64_t deg[2], *common = NULL;
+  int64_t n;
+
+  if (!partition_has(j->a) || !partition_has(j->b)) {
+    j->reply.code = 400;
+  } else if ((n = common_neighbors(j->a, j->b, j->ids ? &common : NULL, deg)) < 0) {
+    // a partition didn't answer
+    j->reply.code = 500;
+  } else {
+    char head[192];
+    uint64_t total = deg[0] + deg[1] - n, k;
+    size_t len = snprintf(head, sizeof(head),
+      "{\"node_a_id\":%" PRIu64 ",\"node_b_id\":%" PRIu64 ",\"count\":%" PRId64
+      ",\"jaccard\":%.6f", j->a, j->b, n, total ? (double) n / total : 0.0);
+    char *p;
+
+    // the head, then ,"ids":[...] if asked for, and the closing brace
+    j->reply.length = len + 1;
+    if (common) {
+      j->reply.length += 8 + 1;
+      for (k = 0; k < (uint64_t) n; k++) j->reply.length += count_digits(common[k]) + (k ? 1 : 0);
+    }
+    j->reply.body = p = (char *) malloc(j->reply.length);
+    if (!p) exit(1);
+    memcpy(p, head, len);
+    p += len;
+    if (common) {
+      memcpy(p, ",\"ids\":[", 8);
+      p += 8;
+      for (k = 0; k < (uint64_t) n; k++) {
+        if (k) *p++ = ',';
+        p += count_digits(common[k]);
+        write_u64(p, common[k]);
+      }
+      *p++ = ']';
+    }
+    *p = '}';
+    j->reply.code = 200;
+  }
+  free(common);
+  send_reply(&j->reply);
+  free(j);
+}
+
+// Pool job: triangles through j->a, with its local clustering coefficient
+static void run_triangle_count(size_t lo, size_t hi, void *arg) {
+  isect_job *j = (isect_job *) arg;
+  uint64_t deg;
+  int64_t n;
+
+  if (!partition_has(j->a)) {
+    j->reply.code = 400;
+  } else if ((n = triangle_count(j->a, &deg)) < 0) {
+    // a partition didn't answer
+    j->reply.code = 500;
+  } else {
+    j->reply.body = (char *) malloc(160);
+    if (!j->reply.body) exit(1);
+    j->reply.length = snprintf(j->reply.body, 160,
+      "{\"node_id\":%" PRIu64 ",\"degree\":%" PRIu64 ",\"triangles\":%" PRId64
+      ",\"clustering\":%.6f}", j->a, deg, n,
+      deg > 1 ? 2.0 * n / ((double) deg * (deg - 1)) : 0.0);
+    j->reply.code = 200;
+  }
+  send_reply(&j->reply);
+  free(j);
+}
+
+// Hands an intersection query on a (and b) to the pool
+static void begin_isect(struct mg_connection *c, void (*fn)(size_t, size_t, void *),
+  uint64_t a, uint64_t b, bool ids) {
+  isect_job *j = (isect_job *) calloc(1, sizeof(isect_job));
+  if (!j) exit(1);
+  c->user_data = (void *) ++last_tag;
+  j->reply.c = c;
+  j->reply.tag = c->user_data;
+  j->a = a;
+  j->b = b;
+  j->ids = ids;
+  pool_submit(fn, j);
 }
 
 // Event handler for request
 static void ev_handler(struct mg_connection *c, int ev, void *p) {
-  if (ev == MG_EV_HTTP_REQUEST) {
+  if (ev == MG_EV_HTTP_CHUNK) {
     struct http_message *hm = (struct http_message *) p;
+
+    // other chunked requests are answered once their whole body is in
+    if (mg_vcmp(&hm->uri, "/api/v1/bulk_load")) return;
+    feed_load(c->flags & BULK_LOADING ? (loader *) c->user_data : begin_load(c, hm),
+      hm->body.p, hm->body.len, false);
+    c->flags |= MG_F_DELETE_CHUNK;
+  }
+  else if (ev == MG_EV_CLOSE && (c->flags & BULK_LOADING)) {
+    // finish the batches already sent off, but answer nobody
+    loader *l = (loader *) c->user_data;
+    l->c = NULL;
+    l->ended = true;
+    end_load(l);
+  }
+  else if ((ev == MG_EV_SEND || ev == MG_EV_POLL) && (c->flags & STREAMING)) {
+    pump_stream(c);
+  }
+  else if (ev == MG_EV_CLOSE && (c->flags & STREAMING)) {
+    end_stream(c);
+  }
+  else if (ev == MG_EV_HTTP_REQUEST) {
+    struct http_message *hm = (struct http_message *) p;
+
+    // stats take no body, so answer before the body checks below
+    if (!mg_vcmp(&hm->uri, "/api/v1/stats")) {
+      respond_stats(c);
+      return;
+    }
+    // a chunked body was taken in as it arrived, so what's left is empty
+    if (!mg_vcmp(&hm->uri, "/api/v1/bulk_load")) {
+      loader *l = c->flags & BULK_LOADING ? (loader *) c->user_data : begin_load(c, hm);
+      feed_load(l, hm->body.p, hm->body.len, true);
+      l->ended = true;
+      end_load(l);
+      return;
+    }
+    if (!mg_vcmp(&hm->uri, "/api/v1/batch")) {
+      begin_batch(c, hm);
+      return;
+    }
     struct json_token* tokens = parse_json2(hm->body.p, hm->body.len);
     char* endptr;
     char* response;
@@ -119,12 +1178,12 @@ static void ev_handler(struct mg_connection *c, int ev, void *p) {
     const char* arg_id = "node_id";
     const char* arg_a = "node_a_id";
     const char* arg_b = "node_b_id";
-    struct json_token* find_id;
-    struct json_token* find_a;
-    struct json_token* find_b;
+    struct json_token* find_id = tokens ? find_json_token(tokens, arg_id) : NULL;
+    struct json_token* find_a = tokens ? find_json_token(tokens, arg_a) : NULL;
+    struct json_token* find_b = tokens ? find_json_token(tokens, arg_b) : NULL;
 
     // Sanity check for endpoint length and body not empty
-    if (hm->uri.len < 16 || (tokens == NULL && strncmp(hm->uri.p, "/api/v1/checkpoint", hm->uri.len))) {
+    if ((hm->uri.len < 16 && mg_vcmp(&hm->uri, "/api/v1/bfs") && mg_vcmp(&hm->uri, "/api/v1/k_hop")) || (tokens == NULL && strncmp(hm->uri.p, "/api/v1/checkpoint", hm->uri.len))) {
       badRequest(c);
       return;
     }
@@ -134,25 +1193,15 @@ static void ev_handler(struct mg_connection *c, int ev, void *p) {
         badRequest(c);
         return;
       }
-pthread_mutex_lock(&mt);
       // index of value
       int index1 = argument_pos(tokens, arg_id);
       uint64_t arg_int = strtoll(tokens[index1 + 1].ptr, &endptr, 10);
-
       if (arg_int% 3 != CHAIN_NUM-1){
         badRequest(c);
+        return;
       }
-      // returns true if successfully added
-      else if (add_vertex(arg_int)) {
-        response = make_json_one("node_id", 7, arg_int);
-        respond(c, 200, strlen(response), response);
-        free(response);
-
-      } else {
-        // vertex already existed
-        respond(c, 204, 0, "");
-      }
-pthread_mutex_unlock(&mt);
+      // acknowledged on the pool, off the poll thread
+      pool_submit(run_add_node, begin_traversal(c, arg_int, 0));
     }
     else if (!strncmp(hm->uri.p, "/api/v1/add_edge", hm->uri.len)) {
       
@@ -161,120 +1210,83 @@ pthread_mutex_unlock(&mt);
         badRequest(c);
         return;
       }
-      pthread_mutex_lock(&mt);
 
       // index of values
       int index1 = argument_pos(tokens, arg_a);
       int index2 = argument_pos(tokens, arg_b);
       uint64_t arg_a_int = strtoll(tokens[index1 + 1].ptr, &endptr, 10);
       uint64_t arg_b_int = strtoll(tokens[index2 + 1].ptr, &endptr, 10);
+      // No stripe is held across the RPCs below: the other partition
+      // takes its own for the edge, so two partitions adding edges to
+      // each other would otherwise wait on each other. A vertex of this
+      // partition never goes away once added, so it is checked unlocked,
+      // and only the local write is locked, as apply_batch does.
 
       // if this is the wrong partition, bad request
       if(!(arg_a_int %3 == CHAIN_NUM-1 || arg_b_int %3 == CHAIN_NUM-1 )){
          badRequest(c);
-        pthread_mutex_unlock(&mt);
          return;
       }
       // if the node(s) that are supposed to be here are not, bad request
       if((arg_a_int %3 == CHAIN_NUM-1 && !(get_node(arg_a_int)))
         ||((arg_b_int %3 == CHAIN_NUM-1) && !(get_node(arg_b_int)))) {
          badRequest(c);
-         pthread_mutex_unlock(&mt);
          return;
       }
+      int code;
       // here we know that any node supposed to be in this partition
       // is in fact here. So if both here, add edge and respond
       if(arg_a_int %3 == CHAIN_NUM-1 && arg_b_int %3 == CHAIN_NUM-1){
-        switch (add_edge(arg_a_int, arg_b_int)) {
-          case 400:
-            respond(c, 400, 0, "");
-          case 204:
-            respond(c, 204, 0, "");
-          case 200:
-            response = make_json_two("node_a_id", "node_b_id", 9, 9, arg_a_int, arg_b_int);
-            respond(c, 200, strlen(response), response);
-            free(response);
-        }
-        pthread_mutex_unlock(&mt);
-        return;
-      }
-      
-      // which partition are the nodes in
-      int arg_a_part = arg_a_int %3 +1;
-      int arg_b_part = arg_b_int %3 +1;
+        lock_edge(arg_a_int, arg_b_int, true);
+        code = add_edge(arg_a_int, arg_b_int);
+        unlock_edge(arg_a_int, arg_b_int);
+      } else {
+        // which partition are the nodes in
+        int arg_a_part = arg_a_int %3 +1;
+        int arg_b_part = arg_b_int %3 +1;
+        // the one in another partition
+        uint64_t far = arg_a_part != CHAIN_NUM ? arg_a_int : arg_b_int;
 
-      bool a_is_off = false;
-      int in_graph_code;
-      int add_code;
-      
-      // if arg_a is in another partition
-      if (arg_a_part != CHAIN_NUM){
-        a_is_off = true;
         // set next IP to the next partition's IP
-        if (arg_a_part == 2){
+        if ((arg_a_part != CHAIN_NUM ? arg_a_part : arg_b_part) == 2){
           NEXT_IP = IP_2;
         }
         else NEXT_IP = IP_3;
-        // does the node exist in the other partition?
-        in_graph_code = send_to_next(GET_NODE, arg_a_int, 0);
         // node does not exist in the other partition, bad request
-        if (in_graph_code == 400){
+        if (ask_owner(far) == 400){
           respond(c, 400, 0, "");
-          pthread_mutex_unlock(&mt);
           return;
         }
-       // add node of current partition to next partition
-       add_code = send_to_next(ADD_NODE, arg_b_int, 0);
-//        if (add_code!=200){
-//           // there is an error, fix it
-//         }
-       // add other partition's node to current partition
-       add_vertex(arg_a_int);
-      }
-      else { // arb_b is in another partition
-        if (arg_b_part == 2){
-           NEXT_IP = IP_2;
-        }
-        else NEXT_IP = IP_3;
-        // does the node exist in the other partition?
-        in_graph_code = send_to_next(GET_NODE, arg_b_int, 0);
-        // node does not exist in the other partition, bad request
-        if (in_graph_code == 400){
-          respond(c, 400, 0, "");
-          pthread_mutex_unlock(&mt);
+
+        // send operation to other partition, which keeps our endpoint as
+        // a ghost for the edge
+        code = send_to_next(ADD_EDGE, arg_a_int, arg_b_int);
+        // if acknowledgment code not OK (=200), respond without writing
+        if (code != 200) {
+          respond(c, code, 0, "");
           return;
         }
-        // add node of current partition to next partition
-        add_code = send_to_next(ADD_NODE, arg_a_int, 0);
-//         if (add_code!=200){
-//           // there is an error, fix it
-//         }
-        // add other partition's node to current partition
-        add_vertex(arg_b_int);
 
+        // if all is good, add the edge in the currect partition, with
+        // the other partition's node as a ghost
+        lock_edge(arg_a_int, arg_b_int, true);
+        code = add_cross_edge(arg_a_int, arg_b_int);
+        unlock_edge(arg_a_int, arg_b_int);
       }
 
-      // send operation to other partition
-      int code = send_to_next(ADD_EDGE, arg_a_int, arg_b_int);
-      // if acknowledgment code not OK (=200), respond without writing
-      if (code != 200) {
-        respond(c, code, 0, "");
-        pthread_mutex_unlock(&mt);
-        return;
-      }
-
-      // if all is good, add the edge in the currect partition
-      switch (add_edge(arg_a_int, arg_b_int)) {
+      switch (code) {
         case 400:
-        respond(c, 400, 0, "");
+          respond(c, 400, 0, "");
+          break;
         case 204:
-        respond(c, 204, 0, "");
+          respond(c, 204, 0, "");
+          break;
         case 200:
-        response = make_json_two("node_a_id", "node_b_id", 9, 9, arg_a_int, arg_b_int);
-        respond(c, 200, strlen(response), response);
-        free(response);
+          response = make_json_two("node_a_id", "node_b_id", 9, 9, arg_a_int, arg_b_int);
+          respond(c, 200, strlen(response), response);
+          free(response);
+          break;
       }
-pthread_mutex_unlock(&mt);
     }
     else if (!strncmp(hm->uri.p, "/api/v1/remove_edge", hm->uri.len)) {
       // body does not contain expected keys
@@ -282,69 +1294,61 @@ pthread_mutex_unlock(&mt);
         badRequest(c);
         return;
       }
-pthread_mutex_lock(&mt);
       // index of values
       int index1 = argument_pos(tokens, arg_a);
       int index2 = argument_pos(tokens, arg_b);
       uint64_t arg_a_int = strtoll(tokens[index1 + 1].ptr, &endptr, 10);
       uint64_t arg_b_int = strtoll(tokens[index2 + 1].ptr, &endptr, 10);
-
       // if neither node is supposed to be here, bad request
       if(!(arg_a_int %3 == CHAIN_NUM-1 || arg_b_int %3 == CHAIN_NUM-1 )){
          badRequest(c);
-pthread_mutex_unlock(&mt);
          return;
       }
 
+      bool removed;
       // if both nodes are here
       if(arg_a_int %3 == CHAIN_NUM-1 && arg_b_int %3 == CHAIN_NUM-1){
-        if (remove_edge(arg_a_int, arg_b_int)) {
-          response = make_json_two("node_a_id", "node_b_id", 9, 9, arg_a_int, arg_b_int);
-          respond(c, 200, strlen(response), response);
-          free(response);
-        } else {
-          respond(c, 400, 0, "");
-        }
-pthread_mutex_unlock(&mt);
-        return;
-      }
-      int arg_a_part = arg_a_int %3 +1;
-      int arg_b_part = arg_b_int %3 +1;
-      
-      // if arg_a is on the other partition
-      if (arg_a_part != CHAIN_NUM){
-        if (arg_a_part == 2){
-          NEXT_IP = IP_2;
+        lock_edge(arg_a_int, arg_b_int, true);
+        removed = remove_edge(arg_a_int, arg_b_int);
+        unlock_edge(arg_a_int, arg_b_int);
+      } else {
+        int arg_a_part = arg_a_int %3 +1;
+        int arg_b_part = arg_b_int %3 +1;
+
+        // if arg_a is on the other partition
+        if (arg_a_part != CHAIN_NUM){
+          if (arg_a_part == 2){
+            NEXT_IP = IP_2;
+          }
+          else NEXT_IP = IP_3;
         }
-        else NEXT_IP = IP_3;
-       
-      }
-      else {
-        if (arg_b_part == 2){
-           NEXT_IP = IP_2;
+        else {
+          if (arg_b_part == 2){
+             NEXT_IP = IP_2;
+          }
+          else NEXT_IP = IP_3;
         }
-        else NEXT_IP = IP_3;
-      }
 
-      // send operation to next node
-       int code = send_to_next(REMOVE_EDGE, arg_a_int, arg_b_int);
-      // if acknowledgment code not OK (=200), respond without writing
-      
-      if (code != 200) {
-        respond(c, code, 0, "");
-pthread_mutex_unlock(&mt);
-        return;
+        // send operation to next node first, unlocked, as add_edge does
+        int code = send_to_next(REMOVE_EDGE, arg_a_int, arg_b_int);
+        // if acknowledgment code not OK (=200), respond without writing
+        if (code != 200) {
+          respond(c, code, 0, "");
+          return;
+        }
+        lock_edge(arg_a_int, arg_b_int, true);
+        removed = remove_edge(arg_a_int, arg_b_int);
+        unlock_edge(arg_a_int, arg_b_int);
       }
 
       // if edge does not exist
-      if (remove_edge(arg_a_int, arg_b_int)) {
+      if (removed) {
         response = make_json_two("node_a_id", "node_b_id", 9, 9, arg_a_int, arg_b_int);
         respond(c, 200, strlen(response), response);
         free(response);
       } else {
         respond(c, 400, 0, "");
       }
-pthread_mutex_unlock(&mt);
     }
     else if(!strncmp(hm->uri.p, "/api/v1/get_node", hm->uri.len)) {
       // body does not contain expected key
@@ -352,7 +1356,6 @@ pthread_mutex_unlock(&mt);
         badRequest(c);
         return;
       }
-pthread_mutex_lock(&mt);
       // index of value
       int index1 = argument_pos(tokens, arg_id);
       long long arg_int = strtoll(tokens[index1 + 1].ptr, &endptr, 10);
@@ -366,7 +1369,6 @@ pthread_mutex_lock(&mt);
       else{
         badRequest(c);
       }
-pthread_mutex_unlock(&mt);
     }
     else if(!strncmp(hm->uri.p, "/api/v1/get_edge", hm->uri.len)) {
       // body does not contain expected keys
@@ -374,7 +1376,6 @@ pthread_mutex_unlock(&mt);
         badRequest(c);
         return;
       }
-      pthread_mutex_lock(&mt);
       // index of values
       int index1 = argument_pos(tokens, arg_a);
       int index2 = argument_pos(tokens, arg_b);
@@ -392,7 +1393,6 @@ pthread_mutex_unlock(&mt);
         // if node does not exist, bad request
         if (!(get_node(arg_a_int))){
            badRequest(c);
-           pthread_mutex_unlock(&mt);
            return;
         }
         // else, arg_a exists
@@ -403,7 +1403,6 @@ pthread_mutex_unlock(&mt);
         // if node does not exist, bad request
         if (!(get_node(arg_b_int))){
            badRequest(c);
-           pthread_mutex_unlock(&mt);
            return;
         }
         else b_in = true;
@@ -411,25 +1410,22 @@ pthread_mutex_unlock(&mt);
 
       if (arg_a_part != CHAIN_NUM){
         (arg_a_part == 2) ? (NEXT_IP = IP_2) : (NEXT_IP = IP_3);
-       if(400 ==send_to_next(GET_NODE, arg_a_int, 0)){
+       if(400 ==ask_owner(arg_a_int)){
         respond(c, 400, 0, "");
-        pthread_mutex_unlock(&mt);
         return;
        }
        a_in = true;
      }
      if (arg_b_part !=CHAIN_NUM) {
         (arg_b_part == 2) ? (NEXT_IP = IP_2) : (NEXT_IP = IP_3);
-       if(400 ==send_to_next(GET_NODE, arg_b_int, 0)){
+       if(400 ==ask_owner(arg_b_int)){
         respond(c, 400, 0, "");
-        pthread_mutex_unlock(&mt);
         return;
        }
        b_in = true;
      }
       if (!a_in || !b_in){
         respond(c, 400, 0, "");
-        pthread_mutex_unlock(&mt);
         return;
       }
       
@@ -437,7 +1433,6 @@ pthread_mutex_unlock(&mt);
       response = make_json_one("in_graph", 8, in_graph);
       respond(c, 200, strlen(response), response);
       free(response);
-      pthread_mutex_unlock(&mt);
     }
     else if(!strncmp(hm->uri.p, "/api/v1/get_neighbors", hm->uri.len)) {
       // body does not contain expected key
@@ -445,23 +1440,117 @@ pthread_mutex_unlock(&mt);
         badRequest(c);
         return;
       }
-pthread_mutex_lock(&mt);
       // index of value
       int index1 = argument_pos(tokens, arg_id);
       long long arg_int = strtoll(tokens[index1 + 1].ptr, &endptr, 10);
+      struct json_token* find_limit = find_json_token(tokens, "limit");
+      struct json_token* find_after = find_json_token(tokens, "after");
+      struct json_token* find_stream = find_json_token(tokens, "stream");
 
-      if (!get_node(arg_int) ) {
-        respond(c, 400, 0, "");
+      if (find_stream && find_stream->type == JSON_TYPE_TRUE) {
+        begin_stream(c, arg_int);
+      } else if (find_limit || find_after) {
+        uint64_t limit = find_limit ? strtoull(find_limit->ptr, &endptr, 10) : NEIGHBORS_PAGE;
+        uint64_t after = find_after ? strtoull(find_after->ptr, &endptr, 10) : 0;
+        if (!limit || limit > NEIGHBORS_PAGE_MAX) {
+          badRequest(c);
+          return;
+        }
+        send_neighbor_page(c, arg_int, find_after != NULL, after, limit);
       } else {
-        int size;
-        uint64_t *neighbors = get_neighbors(arg_int, &size);
-        char* neighbor_array = format_neighbors(neighbors, size);
-        response = make_neighbor_response("node_id", "neighbors", 7, 9, arg_int, neighbor_array);
-        respond(c, 200, strlen(response), response);
-        free(response);
-        free(neighbors);
+        send_neighbors(c, arg_int);
+      }
+    }
+    else if (!mg_vcmp(&hm->uri, "/api/v1/get_degree")) {
+      // body does not contain expected key
+      if(find_id == 0) {
+        badRequest(c);
+        return;
+      }
+      // index of value
+      int index1 = argument_pos(tokens, arg_id);
+      send_degree(c, strtoull(tokens[index1 + 1].ptr, &endptr, 10));
+    }
+    else if (!mg_vcmp(&hm->uri, "/api/v1/get_degrees")) {
+      send_degrees(c, find_json_token(tokens, "node_ids"));
+    }
+    else if(!strncmp(hm->uri.p, "/api/v1/shortest_path", hm->uri.len)) {
+      // body does not contain expected keys
+      if(find_a == 0 || find_b == 0) {
+        badRequest(c);
+        return;
+      }
+      // index of values
+      int index1 = argument_pos(tokens, arg_a);
+      int index2 = argument_pos(tokens, arg_b);
+      uint64_t arg_a_int = strtoull(tokens[index1 + 1].ptr, &endptr, 10);
+      uint64_t arg_b_int = strtoull(tokens[index2 + 1].ptr, &endptr, 10);
+
+      pool_submit(run_shortest_path, begin_traversal(c, arg_a_int, arg_b_int));
+    }
+    else if (!mg_vcmp(&hm->uri, "/api/v1/bfs")) {
+      // body does not contain expected key
+      if(find_id == 0) {
+        badRequest(c);
+        return;
       }
-pthread_mutex_unlock(&mt);
+      // index of value
+      int index1 = argument_pos(tokens, arg_id);
+      uint64_t arg_int = strtoull(tokens[index1 + 1].ptr, &endptr, 10);
+
+      pool_submit(run_bfs, begin_traversal(c, arg_int, 0));
+    }
+    else if (!mg_vcmp(&hm->uri, "/api/v1/common_neighbors")) {
+      struct json_token* find_ids = find_json_token(tokens, "ids");
+
+      // body does not contain expected keys
+      if(find_a == 0 || find_b == 0) {
+        badRequest(c);
+        return;
+      }
+      // index of values
+      int index1 = argument_pos(tokens, arg_a);
+      int index2 = argument_pos(tokens, arg_b);
+      uint64_t arg_a_int = strtoull(tokens[index1 + 1].ptr, &endptr, 10);
+      uint64_t arg_b_int = strtoull(tokens[index2 + 1].ptr, &endptr, 10);
+
+      begin_isect(c, run_common_neighbors, arg_a_int, arg_b_int,
+        find_ids && find_ids->type == JSON_TYPE_TRUE);
+    }
+    else if (!mg_vcmp(&hm->uri, "/api/v1/triangle_count")) {
+      // body does not contain expected key
+      if(find_id == 0) {
+        badRequest(c);
+        return;
+      }
+      // index of value
+      int index1 = argument_pos(tokens, arg_id);
+      uint64_t arg_int = strtoull(tokens[index1 + 1].ptr, &endptr, 10);
+
+      begin_isect(c, run_triangle_count, arg_int, 0, false);
+    }
+    else if (!mg_vcmp(&hm->uri, "/api/v1/k_hop")) {
+      struct json_token* find_k = find_json_token(tokens, "k");
+      struct json_token* find_limit = find_json_token(tokens, "limit");
+      struct json_token* find_ids = find_json_token(tokens, "ids");
+      uint64_t k, limit = UINT64_MAX;
+
+      // body does not contain expected keys
+      if (find_id == 0 || find_k == 0 || find_k->type != JSON_TYPE_NUMBER) {
+        badRequest(c);
+        return;
+      }
+      k = strtoull(find_k->ptr, &endptr, 10);
+      if (find_limit) limit = strtoull(find_limit->ptr, &endptr, 10);
+      if (!k || k > KHOP_MAX_K || !limit) {
+        badRequest(c);
+        return;
+      }
+      // index of value
+      int index1 = argument_pos(tokens, arg_id);
+      uint64_t arg_int = strtoull(tokens[index1 + 1].ptr, &endptr, 10);
+
+      begin_k_hop(c, arg_int, k, limit, find_ids && find_ids->type == JSON_TYPE_TRUE);
     }
     else {
       respond(c, 400, 0, "");
@@ -471,14 +1560,15 @@ pthread_mutex_unlock(&mt);
 
 int main(int argc, char** argv) {
   //ensure correct number of arguments
-  if (argc != 8) {
+  if (argc < 8) {
     fprintf(stderr, 
-      "Usage: ./cs426_graph_server <graph_server_port> -p <partnum> -l <partlist> \n");
+      "Usage: ./cs426_graph_server <graph_server_port> -p <partnum> -l <partlist> [-d <hub_degree>] [-w <workers>] [-z]\n");
     return 1;
   }
 
   int cc;
-  while ((cc = getopt (argc, argv, "p:l:")) != -1){
+  int workers = sysconf(_SC_NPROCESSORS_ONLN);
+  while ((cc = getopt (argc, argv, "p:l:d:w:z")) != -1){
     switch (cc)
     {
       case 'p':
@@ -487,8 +1577,17 @@ int main(int argc, char** argv) {
       case 'l':
         IP_1 = optarg;
         break;
+      case 'd':
+        hub_threshold = strtoul(optarg, NULL, 10);
+        break;
+      case 'w':
+        workers = atoi(optarg);
+        break;
+      case 'z':
+        adj_compress = true;
+        break;
       case '?':
-        if (optopt == 'p')
+        if (optopt == 'p' || optopt == 'l' || optopt == 'd' || optopt == 'w')
           fprintf(stderr, "Option -%c requires an argument. \n", optopt);
         else if (isprint (optopt))
           fprintf(stderr, "Unknown option '-%c'.\n", optopt);
@@ -515,6 +1614,9 @@ int main(int argc, char** argv) {
   fprintf(stderr, "Chain num is %d\n", CHAIN_NUM);
 
   // find the rpc port of the current vm
+  if (CHAIN_NUM == 1){
+   RPC_PORT = strchr(IP_1, ':');
+  }
   if (CHAIN_NUM == 2){
    RPC_PORT = strchr(IP_2, ':');
 
@@ -522,7 +1624,6 @@ int main(int argc, char** argv) {
   if (CHAIN_NUM == 3){
    RPC_PORT = strchr(IP_3, ':');
   }
-  struct mg_mgr mgr;
   struct mg_connection *c;
 
   // pass in void pointer
@@ -531,14 +1632,18 @@ int main(int argc, char** argv) {
   c = mg_bind(&mgr, s_http_port, ev_handler);
   mg_set_protocol_http_websocket(c);
 
-  map.nsize = 0;
-  map.esize = 0;
-  map.table = (vertex **) malloc(SIZE * sizeof(vertex*));
+  init_map();
+  pool_init(workers);
 
-  int i;
-  for (i = 0; i < SIZE; i++) (map.table)[i] = NULL;
+  // rebuild the CSR snapshot in the background
+  pthread_t csr;
+  if (pthread_create(&csr, NULL, csr_thread, NULL)) {
+    fprintf(stderr, "Error creating thread\n");
+    return 1;
+  }
 
-  if (CHAIN_NUM != 1) {
+  // every partition serves frontiers for distributed searches
+  if (RPC_PORT) {
     // create reference to second thread
     pthread_t inc_x_thread;
     int x;
@@ -548,6 +1653,13 @@ int main(int argc, char** argv) {
       fprintf(stderr, "Error creating thread\n");
       return 1;
     }
+
+    // and ships its filter to the others
+    pthread_t filter;
+    if (pthread_create(&filter, NULL, filter_thread, NULL)) {
+      fprintf(stderr, "Error creating thread\n");
+      return 1;
+    }
   }
 
   for (;;) {
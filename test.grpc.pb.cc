@@ -21,6 +21,11 @@ static const char* Mutator_method_names[] = {
   "/mutate.Mutator/add_edge_alt",
   "/mutate.Mutator/remove_edge_alt",
   "/mutate.Mutator/get_node_alt",
+  "/mutate.Mutator/expand_frontier",
+  "/mutate.Mutator/add_edges",
+  "/mutate.Mutator/apply_ops",
+  "/mutate.Mutator/count_common",
+  "/mutate.Mutator/push_filter",
 };
 
 std::unique_ptr< Mutator::Stub> Mutator::NewStub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options) {
@@ -34,6 +39,11 @@ Mutator::Stub::Stub(const std::shared_ptr< ::grpc::ChannelInterface>& channel)
   , rpcmethod_add_edge_alt_(Mutator_method_names[2], ::grpc::RpcMethod::NORMAL_RPC, channel)
   , rpcmethod_remove_edge_alt_(Mutator_method_names[3], ::grpc::RpcMethod::NORMAL_RPC, channel)
   , rpcmethod_get_node_alt_(Mutator_method_names[4], ::grpc::RpcMethod::NORMAL_RPC, channel)
+  , rpcmethod_expand_frontier_(Mutator_method_names[5], ::grpc::RpcMethod::NORMAL_RPC, channel)
+  , rpcmethod_add_edges_(Mutator_method_names[6], ::grpc::RpcMethod::NORMAL_RPC, channel)
+  , rpcmethod_apply_ops_(Mutator_method_names[7], ::grpc::RpcMethod::NORMAL_RPC, channel)
+  , rpcmethod_count_common_(Mutator_method_names[8], ::grpc::RpcMethod::NORMAL_RPC, channel)
+  , rpcmethod_push_filter_(Mutator_method_names[9], ::grpc::RpcMethod::NORMAL_RPC, channel)
   {}
 
 ::grpc::Status Mutator::Stub::add_node(::grpc::ClientContext* context, const ::mutate::Node& request, ::mutate::Code* response) {
@@ -76,6 +86,46 @@ Mutator::Stub::Stub(const std::shared_ptr< ::grpc::ChannelInterface>& channel)
   return new ::grpc::ClientAsyncResponseReader< ::mutate::Code>(channel_.get(), cq, rpcmethod_get_node_alt_, context, request);
 }
 
+::grpc::Status Mutator::Stub::expand_frontier(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::mutate::Frontier* response) {
+  return ::grpc::BlockingUnaryCall(channel_.get(), rpcmethod_expand_frontier_, context, request, response);
+}
+
+::grpc::ClientAsyncResponseReader< ::mutate::Frontier>* Mutator::Stub::Asyncexpand_frontierRaw(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) {
+  return new ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>(channel_.get(), cq, rpcmethod_expand_frontier_, context, request);
+}
+
+::grpc::Status Mutator::Stub::add_edges(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::mutate::Code* response) {
+  return ::grpc::BlockingUnaryCall(channel_.get(), rpcmethod_add_edges_, context, request, response);
+}
+
+::grpc::ClientAsyncResponseReader< ::mutate::Code>* Mutator::Stub::Asyncadd_edgesRaw(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::grpc::CompletionQueue* cq) {
+  return new ::grpc::ClientAsyncResponseReader< ::mutate::Code>(channel_.get(), cq, rpcmethod_add_edges_, context, request);
+}
+
+::grpc::Status Mutator::Stub::apply_ops(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::mutate::OpBatch* response) {
+  return ::grpc::BlockingUnaryCall(channel_.get(), rpcmethod_apply_ops_, context, request, response);
+}
+
+::grpc::ClientAsyncResponseReader< ::mutate::OpBatch>* Mutator::Stub::Asyncapply_opsRaw(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::grpc::CompletionQueue* cq) {
+  return new ::grpc::ClientAsyncResponseReader< ::mutate::OpBatch>(channel_.get(), cq, rpcmethod_apply_ops_, context, request);
+}
+
+::grpc::Status Mutator::Stub::count_common(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::mutate::Frontier* response) {
+  return ::grpc::BlockingUnaryCall(channel_.get(), rpcmethod_count_common_, context, request, response);
+}
+
+::grpc::ClientAsyncResponseReader< ::mutate::Frontier>* Mutator::Stub::Asynccount_commonRaw(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) {
+  return new ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>(channel_.get(), cq, rpcmethod_count_common_, context, request);
+}
+
+::grpc::Status Mutator::Stub::push_filter(::grpc::ClientContext* context, const ::mutate::Filter& request, ::mutate::Code* response) {
+  return ::grpc::BlockingUnaryCall(channel_.get(), rpcmethod_push_filter_, context, request, response);
+}
+
+::grpc::ClientAsyncResponseReader< ::mutate::Code>* Mutator::Stub::Asyncpush_filterRaw(::grpc::ClientContext* context, const ::mutate::Filter& request, ::grpc::CompletionQueue* cq) {
+  return new ::grpc::ClientAsyncResponseReader< ::mutate::Code>(channel_.get(), cq, rpcmethod_push_filter_, context, request);
+}
+
 Mutator::Service::Service() {
   (void)Mutator_method_names;
   AddMethod(new ::grpc::RpcServiceMethod(
@@ -103,6 +153,31 @@ Mutator::Service::Service() {
       ::grpc::RpcMethod::NORMAL_RPC,
       new ::grpc::RpcMethodHandler< Mutator::Service, ::mutate::Node, ::mutate::Code>(
           std::mem_fn(&Mutator::Service::get_node_alt), this)));
+  AddMethod(new ::grpc::RpcServiceMethod(
+      Mutator_method_names[5],
+      ::grpc::RpcMethod::NORMAL_RPC,
+      new ::grpc::RpcMethodHandler< Mutator::Service, ::mutate::Frontier, ::mutate::Frontier>(
+          std::mem_fn(&Mutator::Service::expand_frontier), this)));
+  AddMethod(new ::grpc::RpcServiceMethod(
+      Mutator_method_names[6],
+      ::grpc::RpcMethod::NORMAL_RPC,
+      new ::grpc::RpcMethodHandler< Mutator::Service, ::mutate::EdgeBatch, ::mutate::Code>(
+          std::mem_fn(&Mutator::Service::add_edges), this)));
+  AddMethod(new ::grpc::RpcServiceMethod(
+      Mutator_method_names[7],
+      ::grpc::RpcMethod::NORMAL_RPC,
+      new ::grpc::RpcMethodHandler< Mutator::Service, ::mutate::OpBatch, ::mutate::OpBatch>(
+          std::mem_fn(&Mutator::Service::apply_ops), this)));
+  AddMethod(new ::grpc::RpcServiceMethod(
+      Mutator_method_names[8],
+      ::grpc::RpcMethod::NORMAL_RPC,
+      new ::grpc::RpcMethodHandler< Mutator::Service, ::mutate::Frontier, ::mutate::Frontier>(
+          std::mem_fn(&Mutator::Service::count_common), this)));
+  AddMethod(new ::grpc::RpcServiceMethod(
+      Mutator_method_names[9],
+      ::grpc::RpcMethod::NORMAL_RPC,
+      new ::grpc::RpcMethodHandler< Mutator::Service, ::mutate::Filter, ::mutate::Code>(
+          std::mem_fn(&Mutator::Service::push_filter), this)));
 }
 
 Mutator::Service::~Service() {
@@ -143,6 +218,41 @@ Mutator::Service::~Service() {
   return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
 }
 
+::grpc::Status Mutator::Service::expand_frontier(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response) {
+  (void) context;
+  (void) request;
+  (void) response;
+  return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+}
+
+::grpc::Status Mutator::Service::add_edges(::grpc::ServerContext* context, const ::mutate::EdgeBatch* request, ::mutate::Code* response) {
+  (void) context;
+  (void) request;
+  (void) response;
+  return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+}
+
+::grpc::Status Mutator::Service::apply_ops(::grpc::ServerContext* context, const ::mutate::OpBatch* request, ::mutate::OpBatch* response) {
+  (void) context;
+  (void) request;
+  (void) response;
+  return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+}
+
+::grpc::Status Mutator::Service::count_common(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response) {
+  (void) context;
+  (void) request;
+  (void) response;
+  return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+}
+
+::grpc::Status Mutator::Service::push_filter(::grpc::ServerContext* context, const ::mutate::Filter* request, ::mutate::Code* response) {
+  (void) context;
+  (void) request;
+  (void) response;
+  return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+}
+
 
 }  // namespace mutate
 
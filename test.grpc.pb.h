@@ -81,12 +81,37 @@ class Mutator GRPC_FINAL {
     std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>> Asyncget_node_alt(::grpc::ClientContext* context, const ::mutate::Node& request, ::grpc::CompletionQueue* cq) {
       return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>>(Asyncget_node_altRaw(context, request, cq));
     }
+    virtual ::grpc::Status expand_frontier(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::mutate::Frontier* response) = 0;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Frontier>> Asyncexpand_frontier(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Frontier>>(Asyncexpand_frontierRaw(context, request, cq));
+    }
+    virtual ::grpc::Status add_edges(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::mutate::Code* response) = 0;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>> Asyncadd_edges(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>>(Asyncadd_edgesRaw(context, request, cq));
+    }
+    virtual ::grpc::Status apply_ops(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::mutate::OpBatch* response) = 0;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::OpBatch>> Asyncapply_ops(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::OpBatch>>(Asyncapply_opsRaw(context, request, cq));
+    }
+    virtual ::grpc::Status count_common(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::mutate::Frontier* response) = 0;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Frontier>> Asynccount_common(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Frontier>>(Asynccount_commonRaw(context, request, cq));
+    }
+    virtual ::grpc::Status push_filter(::grpc::ClientContext* context, const ::mutate::Filter& request, ::mutate::Code* response) = 0;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>> Asyncpush_filter(::grpc::ClientContext* context, const ::mutate::Filter& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>>(Asyncpush_filterRaw(context, request, cq));
+    }
   private:
     virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>* Asyncadd_nodeRaw(::grpc::ClientContext* context, const ::mutate::Node& request, ::grpc::CompletionQueue* cq) = 0;
     virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>* Asyncremove_nodeRaw(::grpc::ClientContext* context, const ::mutate::Node& request, ::grpc::CompletionQueue* cq) = 0;
     virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>* Asyncadd_edge_altRaw(::grpc::ClientContext* context, const ::mutate::Edge& request, ::grpc::CompletionQueue* cq) = 0;
     virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>* Asyncremove_edge_altRaw(::grpc::ClientContext* context, const ::mutate::Edge& request, ::grpc::CompletionQueue* cq) = 0;
     virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>* Asyncget_node_altRaw(::grpc::ClientContext* context, const ::mutate::Node& request, ::grpc::CompletionQueue* cq) = 0;
+    virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Frontier>* Asyncexpand_frontierRaw(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) = 0;
+    virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>* Asyncadd_edgesRaw(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::grpc::CompletionQueue* cq) = 0;
+    virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::OpBatch>* Asyncapply_opsRaw(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::grpc::CompletionQueue* cq) = 0;
+    virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Frontier>* Asynccount_commonRaw(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) = 0;
+    virtual ::grpc::ClientAsyncResponseReaderInterface< ::mutate::Code>* Asyncpush_filterRaw(::grpc::ClientContext* context, const ::mutate::Filter& request, ::grpc::CompletionQueue* cq) = 0;
   };
   class Stub GRPC_FINAL : public StubInterface {
    public:
@@ -111,6 +136,26 @@ class Mutator GRPC_FINAL {
     std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Code>> Asyncget_node_alt(::grpc::ClientContext* context, const ::mutate::Node& request, ::grpc::CompletionQueue* cq) {
       return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Code>>(Asyncget_node_altRaw(context, request, cq));
     }
+    ::grpc::Status expand_frontier(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::mutate::Frontier* response) GRPC_OVERRIDE;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>> Asyncexpand_frontier(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>>(Asyncexpand_frontierRaw(context, request, cq));
+    }
+    ::grpc::Status add_edges(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::mutate::Code* response) GRPC_OVERRIDE;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Code>> Asyncadd_edges(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Code>>(Asyncadd_edgesRaw(context, request, cq));
+    }
+    ::grpc::Status apply_ops(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::mutate::OpBatch* response) GRPC_OVERRIDE;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::OpBatch>> Asyncapply_ops(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::OpBatch>>(Asyncapply_opsRaw(context, request, cq));
+    }
+    ::grpc::Status count_common(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::mutate::Frontier* response) GRPC_OVERRIDE;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>> Asynccount_common(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>>(Asynccount_commonRaw(context, request, cq));
+    }
+    ::grpc::Status push_filter(::grpc::ClientContext* context, const ::mutate::Filter& request, ::mutate::Code* response) GRPC_OVERRIDE;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Code>> Asyncpush_filter(::grpc::ClientContext* context, const ::mutate::Filter& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::mutate::Code>>(Asyncpush_filterRaw(context, request, cq));
+    }
 
    private:
     std::shared_ptr< ::grpc::ChannelInterface> channel_;
@@ -119,11 +164,21 @@ class Mutator GRPC_FINAL {
     ::grpc::ClientAsyncResponseReader< ::mutate::Code>* Asyncadd_edge_altRaw(::grpc::ClientContext* context, const ::mutate::Edge& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
     ::grpc::ClientAsyncResponseReader< ::mutate::Code>* Asyncremove_edge_altRaw(::grpc::ClientContext* context, const ::mutate::Edge& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
     ::grpc::ClientAsyncResponseReader< ::mutate::Code>* Asyncget_node_altRaw(::grpc::ClientContext* context, const ::mutate::Node& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
+    ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>* Asyncexpand_frontierRaw(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
+    ::grpc::ClientAsyncResponseReader< ::mutate::Code>* Asyncadd_edgesRaw(::grpc::ClientContext* context, const ::mutate::EdgeBatch& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
+    ::grpc::ClientAsyncResponseReader< ::mutate::OpBatch>* Asyncapply_opsRaw(::grpc::ClientContext* context, const ::mutate::OpBatch& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
+    ::grpc::ClientAsyncResponseReader< ::mutate::Frontier>* Asynccount_commonRaw(::grpc::ClientContext* context, const ::mutate::Frontier& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
+    ::grpc::ClientAsyncResponseReader< ::mutate::Code>* Asyncpush_filterRaw(::grpc::ClientContext* context, const ::mutate::Filter& request, ::grpc::CompletionQueue* cq) GRPC_OVERRIDE;
     const ::grpc::RpcMethod rpcmethod_add_node_;
     const ::grpc::RpcMethod rpcmethod_remove_node_;
     const ::grpc::RpcMethod rpcmethod_add_edge_alt_;
     const ::grpc::RpcMethod rpcmethod_remove_edge_alt_;
     const ::grpc::RpcMethod rpcmethod_get_node_alt_;
+    const ::grpc::RpcMethod rpcmethod_expand_frontier_;
+    const ::grpc::RpcMethod rpcmethod_add_edges_;
+    const ::grpc::RpcMethod rpcmethod_apply_ops_;
+    const ::grpc::RpcMethod rpcmethod_count_common_;
+    const ::grpc::RpcMethod rpcmethod_push_filter_;
   };
   static std::unique_ptr<Stub> NewStub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options = ::grpc::StubOptions());
 
@@ -137,6 +192,11 @@ class Mutator GRPC_FINAL {
     virtual ::grpc::Status add_edge_alt(::grpc::ServerContext* context, const ::mutate::Edge* request, ::mutate::Code* response);
     virtual ::grpc::Status remove_edge_alt(::grpc::ServerContext* context, const ::mutate::Edge* request, ::mutate::Code* response);
     virtual ::grpc::Status get_node_alt(::grpc::ServerContext* context, const ::mutate::Node* request, ::mutate::Code* response);
+    virtual ::grpc::Status expand_frontier(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response);
+    virtual ::grpc::Status add_edges(::grpc::ServerContext* context, const ::mutate::EdgeBatch* request, ::mutate::Code* response);
+    virtual ::grpc::Status apply_ops(::grpc::ServerContext* context, const ::mutate::OpBatch* request, ::mutate::OpBatch* response);
+    virtual ::grpc::Status count_common(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response);
+    virtual ::grpc::Status push_filter(::grpc::ServerContext* context, const ::mutate::Filter* request, ::mutate::Code* response);
   };
   template <class BaseClass>
   class WithAsyncMethod_add_node : public BaseClass {
@@ -238,7 +298,107 @@ class Mutator GRPC_FINAL {
       ::grpc::Service::RequestAsyncUnary(4, context, request, response, new_call_cq, notification_cq, tag);
     }
   };
-  typedef WithAsyncMethod_add_node<WithAsyncMethod_remove_node<WithAsyncMethod_add_edge_alt<WithAsyncMethod_remove_edge_alt<WithAsyncMethod_get_node_alt<Service > > > > > AsyncService;
+  template <class BaseClass>
+  class WithAsyncMethod_expand_frontier : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithAsyncMethod_expand_frontier() {
+      ::grpc::Service::MarkMethodAsync(5);
+    }
+    ~WithAsyncMethod_expand_frontier() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status expand_frontier(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+    void Requestexpand_frontier(::grpc::ServerContext* context, ::mutate::Frontier* request, ::grpc::ServerAsyncResponseWriter< ::mutate::Frontier>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
+      ::grpc::Service::RequestAsyncUnary(5, context, request, response, new_call_cq, notification_cq, tag);
+    }
+  };
+  template <class BaseClass>
+  class WithAsyncMethod_add_edges : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithAsyncMethod_add_edges() {
+      ::grpc::Service::MarkMethodAsync(6);
+    }
+    ~WithAsyncMethod_add_edges() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status add_edges(::grpc::ServerContext* context, const ::mutate::EdgeBatch* request, ::mutate::Code* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+    void Requestadd_edges(::grpc::ServerContext* context, ::mutate::EdgeBatch* request, ::grpc::ServerAsyncResponseWriter< ::mutate::Code>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
+      ::grpc::Service::RequestAsyncUnary(6, context, request, response, new_call_cq, notification_cq, tag);
+    }
+  };
+  template <class BaseClass>
+  class WithAsyncMethod_apply_ops : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithAsyncMethod_apply_ops() {
+      ::grpc::Service::MarkMethodAsync(7);
+    }
+    ~WithAsyncMethod_apply_ops() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status apply_ops(::grpc::ServerContext* context, const ::mutate::OpBatch* request, ::mutate::OpBatch* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+    void Requestapply_ops(::grpc::ServerContext* context, ::mutate::OpBatch* request, ::grpc::ServerAsyncResponseWriter< ::mutate::OpBatch>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
+      ::grpc::Service::RequestAsyncUnary(7, context, request, response, new_call_cq, notification_cq, tag);
+    }
+  };
+  template <class BaseClass>
+  class WithAsyncMethod_count_common : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithAsyncMethod_count_common() {
+      ::grpc::Service::MarkMethodAsync(8);
+    }
+    ~WithAsyncMethod_count_common() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status count_common(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+    void Requestcount_common(::grpc::ServerContext* context, ::mutate::Frontier* request, ::grpc::ServerAsyncResponseWriter< ::mutate::Frontier>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
+      ::grpc::Service::RequestAsyncUnary(8, context, request, response, new_call_cq, notification_cq, tag);
+    }
+  };
+  template <class BaseClass>
+  class WithAsyncMethod_push_filter : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithAsyncMethod_push_filter() {
+      ::grpc::Service::MarkMethodAsync(9);
+    }
+    ~WithAsyncMethod_push_filter() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status push_filter(::grpc::ServerContext* context, const ::mutate::Filter* request, ::mutate::Code* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+    void Requestpush_filter(::grpc::ServerContext* context, ::mutate::Filter* request, ::grpc::ServerAsyncResponseWriter< ::mutate::Code>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
+      ::grpc::Service::RequestAsyncUnary(9, context, request, response, new_call_cq, notification_cq, tag);
+    }
+  };
+  typedef WithAsyncMethod_add_node<WithAsyncMethod_remove_node<WithAsyncMethod_add_edge_alt<WithAsyncMethod_remove_edge_alt<WithAsyncMethod_get_node_alt<WithAsyncMethod_expand_frontier<WithAsyncMethod_add_edges<WithAsyncMethod_apply_ops<WithAsyncMethod_count_common<WithAsyncMethod_push_filter<Service > > > > > > > > > > AsyncService;
   template <class BaseClass>
   class WithGenericMethod_add_node : public BaseClass {
    private:
@@ -324,6 +484,91 @@ class Mutator GRPC_FINAL {
       return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
     }
   };
+  template <class BaseClass>
+  class WithGenericMethod_expand_frontier : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithGenericMethod_expand_frontier() {
+      ::grpc::Service::MarkMethodGeneric(5);
+    }
+    ~WithGenericMethod_expand_frontier() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status expand_frontier(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+  };
+  template <class BaseClass>
+  class WithGenericMethod_add_edges : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithGenericMethod_add_edges() {
+      ::grpc::Service::MarkMethodGeneric(6);
+    }
+    ~WithGenericMethod_add_edges() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status add_edges(::grpc::ServerContext* context, const ::mutate::EdgeBatch* request, ::mutate::Code* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+  };
+  template <class BaseClass>
+  class WithGenericMethod_apply_ops : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithGenericMethod_apply_ops() {
+      ::grpc::Service::MarkMethodGeneric(7);
+    }
+    ~WithGenericMethod_apply_ops() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status apply_ops(::grpc::ServerContext* context, const ::mutate::OpBatch* request, ::mutate::OpBatch* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+  };
+  template <class BaseClass>
+  class WithGenericMethod_count_common : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithGenericMethod_count_common() {
+      ::grpc::Service::MarkMethodGeneric(8);
+    }
+    ~WithGenericMethod_count_common() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status count_common(::grpc::ServerContext* context, const ::mutate::Frontier* request, ::mutate::Frontier* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+  };
+  template <class BaseClass>
+  class WithGenericMethod_push_filter : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithGenericMethod_push_filter() {
+      ::grpc::Service::MarkMethodGeneric(9);
+    }
+    ~WithGenericMethod_push_filter() GRPC_OVERRIDE {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status push_filter(::grpc::ServerContext* context, const ::mutate::Filter* request, ::mutate::Code* response) GRPC_FINAL GRPC_OVERRIDE {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+  };
 };
 
 }  // namespace mutate
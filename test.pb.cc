@@ -30,6 +30,18 @@ const ::google::protobuf::internal::GeneratedMessageReflection*
 const ::google::protobuf::Descriptor* Code_descriptor_ = NULL;
 const ::google::protobuf::internal::GeneratedMessageReflection*
   Code_reflection_ = NULL;
+const ::google::protobuf::Descriptor* Frontier_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  Frontier_reflection_ = NULL;
+const ::google::protobuf::Descriptor* Filter_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  Filter_reflection_ = NULL;
+const ::google::protobuf::Descriptor* OpBatch_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  OpBatch_reflection_ = NULL;
+const ::google::protobuf::Descriptor* EdgeBatch_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  EdgeBatch_reflection_ = NULL;
 
 }  // namespace
 
@@ -87,6 +99,66 @@ void protobuf_AssignDesc_test_2eproto() {
       sizeof(Code),
       GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Code, _internal_metadata_),
       -1);
+  Frontier_descriptor_ = file->message_type(3);
+  static const int Frontier_offsets_[1] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Frontier, ids_),
+  };
+  Frontier_reflection_ =
+    ::google::protobuf::internal::GeneratedMessageReflection::NewGeneratedMessageReflection(
+      Frontier_descriptor_,
+      Frontier::default_instance_,
+      Frontier_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Frontier, _has_bits_[0]),
+      -1,
+      -1,
+      sizeof(Frontier),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Frontier, _internal_metadata_),
+      -1);
+  EdgeBatch_descriptor_ = file->message_type(4);
+  static const int EdgeBatch_offsets_[1] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(EdgeBatch, ids_),
+  };
+  EdgeBatch_reflection_ =
+    ::google::protobuf::internal::GeneratedMessageReflection::NewGeneratedMessageReflection(
+      EdgeBatch_descriptor_,
+      EdgeBatch::default_instance_,
+      EdgeBatch_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(EdgeBatch, _has_bits_[0]),
+      -1,
+      -1,
+      sizeof(EdgeBatch),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(EdgeBatch, _internal_metadata_),
+      -1);
+  OpBatch_descriptor_ = file->message_type(5);
+  static const int OpBatch_offsets_[1] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(OpBatch, ids_),
+  };
+  OpBatch_reflection_ =
+    ::google::protobuf::internal::GeneratedMessageReflection::NewGeneratedMessageReflection(
+      OpBatch_descriptor_,
+      OpBatch::default_instance_,
+      OpBatch_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(OpBatch, _has_bits_[0]),
+      -1,
+      -1,
+      sizeof(OpBatch),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(OpBatch, _internal_metadata_),
+      -1);
+  Filter_descriptor_ = file->message_type(6);
+  static const int Filter_offsets_[1] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Filter, ids_),
+  };
+  Filter_reflection_ =
+    ::google::protobuf::internal::GeneratedMessageReflection::NewGeneratedMessageReflection(
+      Filter_descriptor_,
+      Filter::default_instance_,
+      Filter_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Filter, _has_bits_[0]),
+      -1,
+      -1,
+      sizeof(Filter),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Filter, _internal_metadata_),
+      -1);
 }
 
 namespace {
@@ -106,6 +178,14 @@ void protobuf_RegisterTypes(const ::std::string&) {
       Edge_descriptor_, &Edge::default_instance());
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
       Code_descriptor_, &Code::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+      Frontier_descriptor_, &Frontier::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+      EdgeBatch_descriptor_, &EdgeBatch::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+      OpBatch_descriptor_, &OpBatch::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+      Filter_descriptor_, &Filter::default_instance());
 }
 
 }  // namespace
@@ -117,6 +197,14 @@ void protobuf_ShutdownFile_test_2eproto() {
   delete Edge_reflection_;
   delete Code::default_instance_;
   delete Code_reflection_;
+  delete Frontier::default_instance_;
+  delete Frontier_reflection_;
+  delete EdgeBatch::default_instance_;
+  delete EdgeBatch_reflection_;
+  delete OpBatch::default_instance_;
+  delete OpBatch_reflection_;
+  delete Filter::default_instance_;
+  delete Filter_reflection_;
 }
 
 void protobuf_AddDesc_test_2eproto() GOOGLE_ATTRIBUTE_COLD;
@@ -129,21 +217,38 @@ void protobuf_AddDesc_test_2eproto() {
   ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
     "\n\ntest.proto\022\006mutate\"\022\n\004Node\022\n\n\002id\030\001 \002(\003"
     "\"\"\n\004Edge\022\014\n\004id_a\030\001 \002(\003\022\014\n\004id_b\030\002 \002(\003\"\025\n\004"
-    "Code\022\r\n\004code\030\310\001 \002(\0052\355\001\n\007Mutator\022(\n\010add_n"
-    "ode\022\014.mutate.Node\032\014.mutate.Code\"\000\022+\n\013rem"
-    "ove_node\022\014.mutate.Node\032\014.mutate.Code\"\000\022,"
-    "\n\014add_edge_alt\022\014.mutate.Edge\032\014.mutate.Co"
-    "de\"\000\022/\n\017remove_edge_alt\022\014.mutate.Edge\032\014."
-    "mutate.Code\"\000\022,\n\014get_node_alt\022\014.mutate.N"
-    "ode\032\014.mutate.Code\"\000", 339);
+    "Code\022\r\n\004code\030\310\001 \002(\005\"\033\n\010Frontier\022\017\n\003ids\030\001"
+    " \003(\003B\002\020\001\"\034\n\tEdgeBatch\022\017\n\003ids\030\001 \003(\003B\002\020\001\"\032"
+    "\n\007OpBatch\022\017\n\003ids\030\001 \003(\003B\002\020\001\"\031\n\006Filter\022\017\n\003"
+    "ids\030\001 \003(\003B\002\020\0012\354\003\n\007Mutator\022(\n\010add_node\022\014."
+    "mutate.Node\032\014.mutate.Code\"\000\022+\n\013remove_no"
+    "de\022\014.mutate.Node\032\014.mutate.Code\"\000\022,\n\014add_"
+    "edge_alt\022\014.mutate.Edge\032\014.mutate.Code\"\000\022/"
+    "\n\017remove_edge_alt\022\014.mutate.Edge\032\014.mutate"
+    ".Code\"\000\022,\n\014get_node_alt\022\014.mutate.Node\032\014."
+    "mutate.Code\"\000\0227\n\017expand_frontier\022\020.mutat"
+    "e.Frontier\032\020.mutate.Frontier\"\000\022.\n\tadd_ed"
+    "ges\022\021.mutate.EdgeBatch\032\014.mutate.Code\"\000\022/"
+    "\n\tapply_ops\022\017.mutate.OpBatch\032\017.mutate.Op"
+    "Batch\"\000\0224\n\014count_common\022\020.mutate.Frontie"
+    "r\032\020.mutate.Frontier\"\000\022-\n\013push_filter\022\016.m"
+    "utate.Filter\032\014.mutate.Code\"\000", 708);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "test.proto", &protobuf_RegisterTypes);
   Node::default_instance_ = new Node();
   Edge::default_instance_ = new Edge();
   Code::default_instance_ = new Code();
+  Frontier::default_instance_ = new Frontier();
+  EdgeBatch::default_instance_ = new EdgeBatch();
+  OpBatch::default_instance_ = new OpBatch();
+  Filter::default_instance_ = new Filter();
   Node::default_instance_->InitAsDefaultInstance();
   Edge::default_instance_->InitAsDefaultInstance();
   Code::default_instance_->InitAsDefaultInstance();
+  Frontier::default_instance_->InitAsDefaultInstance();
+  EdgeBatch::default_instance_->InitAsDefaultInstance();
+  OpBatch::default_instance_->InitAsDefaultInstance();
+  Filter::default_instance_->InitAsDefaultInstance();
   ::google::protobuf::internal::OnShutdown(&protobuf_ShutdownFile_test_2eproto);
 }
 
@@ -1070,6 +1175,1202 @@ void Code::clear_code() {
 
 #endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
 
+// ===================================================================
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int Frontier::kIdsFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+Frontier::Frontier()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:mutate.Frontier)
+}
+
+void Frontier::InitAsDefaultInstance() {
+}
+
+Frontier::Frontier(const Frontier& from)
+  : ::google::protobuf::Message(),
+    _internal_metadata_(NULL) {
+  SharedCtor();
+  MergeFrom(from);
+  // @@protoc_insertion_point(copy_constructor:mutate.Frontier)
+}
+
+void Frontier::SharedCtor() {
+  _cached_size_ = 0;
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+Frontier::~Frontier() {
+  // @@protoc_insertion_point(destructor:mutate.Frontier)
+  SharedDtor();
+}
+
+void Frontier::SharedDtor() {
+  if (this != default_instance_) {
+  }
+}
+
+void Frontier::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* Frontier::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return Frontier_descriptor_;
+}
+
+const Frontier& Frontier::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_test_2eproto();
+  return *default_instance_;
+}
+
+Frontier* Frontier::default_instance_ = NULL;
+
+Frontier* Frontier::New(::google::protobuf::Arena* arena) const {
+  Frontier* n = new Frontier;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
+void Frontier::Clear() {
+// @@protoc_insertion_point(message_clear_start:mutate.Frontier)
+  ids_.Clear();
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  if (_internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->Clear();
+  }
+}
+
+bool Frontier::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:mutate.Frontier)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoff(127);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // repeated int64 ids = 1 [packed = true];
+      case 1: {
+        if (tag == 10) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPackedPrimitive<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 input, this->mutable_ids())));
+        } else if (tag == 8) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadRepeatedPrimitiveNoInline<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 1, 10, input, this->mutable_ids())));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectAtEnd()) goto success;
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0 ||
+            ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:mutate.Frontier)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:mutate.Frontier)
+  return false;
+#undef DO_
+}
+
+void Frontier::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:mutate.Frontier)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteTag(1, ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+    output->WriteVarint32(_ids_cached_byte_size_);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt64NoTag(
+      this->ids(i), output);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+  // @@protoc_insertion_point(serialize_end:mutate.Frontier)
+}
+
+::google::protobuf::uint8* Frontier::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  // @@protoc_insertion_point(serialize_to_array_start:mutate.Frontier)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(
+      1,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      target);
+    target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+      _ids_cached_byte_size_, target);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteInt64NoTagToArray(this->ids(i), target);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:mutate.Frontier)
+  return target;
+}
+
+int Frontier::ByteSize() const {
+// @@protoc_insertion_point(message_byte_size_start:mutate.Frontier)
+  int total_size = 0;
+
+  // repeated int64 ids = 1 [packed = true];
+  {
+    int data_size = 0;
+    for (int i = 0; i < this->ids_size(); i++) {
+      data_size += ::google::protobuf::internal::WireFormatLite::
+        Int64Size(this->ids(i));
+    }
+    if (data_size > 0) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(data_size);
+    }
+    GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+    _ids_cached_byte_size_ = data_size;
+    GOOGLE_SAFE_CONCURRENT_WRITES_END();
+    total_size += data_size;
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void Frontier::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:mutate.Frontier)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  const Frontier* source = 
+      ::google::protobuf::internal::DynamicCastToGenerated<const Frontier>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:mutate.Frontier)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:mutate.Frontier)
+    MergeFrom(*source);
+  }
+}
+
+void Frontier::MergeFrom(const Frontier& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:mutate.Frontier)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  ids_.MergeFrom(from.ids_);
+  if (from._internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+  }
+}
+
+void Frontier::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:mutate.Frontier)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void Frontier::CopyFrom(const Frontier& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:mutate.Frontier)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Frontier::IsInitialized() const {
+
+  return true;
+}
+
+void Frontier::Swap(Frontier* other) {
+  if (other == this) return;
+  InternalSwap(other);
+}
+void Frontier::InternalSwap(Frontier* other) {
+  ids_.UnsafeArenaSwap(&other->ids_);
+  std::swap(_has_bits_[0], other->_has_bits_[0]);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  std::swap(_cached_size_, other->_cached_size_);
+}
+
+::google::protobuf::Metadata Frontier::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = Frontier_descriptor_;
+  metadata.reflection = Frontier_reflection_;
+  return metadata;
+}
+
+#if PROTOBUF_INLINE_NOT_IN_HEADERS
+// Frontier
+
+// repeated int64 ids = 1 [packed = true];
+int Frontier::ids_size() const {
+  return ids_.size();
+}
+void Frontier::clear_ids() {
+  ids_.Clear();
+}
+ ::google::protobuf::int64 Frontier::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.Frontier.ids)
+  return ids_.Get(index);
+}
+ void Frontier::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.Frontier.ids)
+}
+ void Frontier::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.Frontier.ids)
+}
+ const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+Frontier::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.Frontier.ids)
+  return ids_;
+}
+ ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+Frontier::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.Frontier.ids)
+  return &ids_;
+}
+
+#endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
+
+// ===================================================================
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int EdgeBatch::kIdsFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+EdgeBatch::EdgeBatch()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:mutate.EdgeBatch)
+}
+
+void EdgeBatch::InitAsDefaultInstance() {
+}
+
+EdgeBatch::EdgeBatch(const EdgeBatch& from)
+  : ::google::protobuf::Message(),
+    _internal_metadata_(NULL) {
+  SharedCtor();
+  MergeFrom(from);
+  // @@protoc_insertion_point(copy_constructor:mutate.EdgeBatch)
+}
+
+void EdgeBatch::SharedCtor() {
+  _cached_size_ = 0;
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+EdgeBatch::~EdgeBatch() {
+  // @@protoc_insertion_point(destructor:mutate.EdgeBatch)
+  SharedDtor();
+}
+
+void EdgeBatch::SharedDtor() {
+  if (this != default_instance_) {
+  }
+}
+
+void EdgeBatch::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* EdgeBatch::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return EdgeBatch_descriptor_;
+}
+
+const EdgeBatch& EdgeBatch::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_test_2eproto();
+  return *default_instance_;
+}
+
+EdgeBatch* EdgeBatch::default_instance_ = NULL;
+
+EdgeBatch* EdgeBatch::New(::google::protobuf::Arena* arena) const {
+  EdgeBatch* n = new EdgeBatch;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
+void EdgeBatch::Clear() {
+// @@protoc_insertion_point(message_clear_start:mutate.EdgeBatch)
+  ids_.Clear();
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  if (_internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->Clear();
+  }
+}
+
+bool EdgeBatch::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:mutate.EdgeBatch)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoff(127);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // repeated int64 ids = 1 [packed = true];
+      case 1: {
+        if (tag == 10) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPackedPrimitive<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 input, this->mutable_ids())));
+        } else if (tag == 8) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadRepeatedPrimitiveNoInline<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 1, 10, input, this->mutable_ids())));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectAtEnd()) goto success;
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0 ||
+            ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:mutate.EdgeBatch)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:mutate.EdgeBatch)
+  return false;
+#undef DO_
+}
+
+void EdgeBatch::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:mutate.EdgeBatch)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteTag(1, ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+    output->WriteVarint32(_ids_cached_byte_size_);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt64NoTag(
+      this->ids(i), output);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+  // @@protoc_insertion_point(serialize_end:mutate.EdgeBatch)
+}
+
+::google::protobuf::uint8* EdgeBatch::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  // @@protoc_insertion_point(serialize_to_array_start:mutate.EdgeBatch)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(
+      1,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      target);
+    target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+      _ids_cached_byte_size_, target);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteInt64NoTagToArray(this->ids(i), target);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:mutate.EdgeBatch)
+  return target;
+}
+
+int EdgeBatch::ByteSize() const {
+// @@protoc_insertion_point(message_byte_size_start:mutate.EdgeBatch)
+  int total_size = 0;
+
+  // repeated int64 ids = 1 [packed = true];
+  {
+    int data_size = 0;
+    for (int i = 0; i < this->ids_size(); i++) {
+      data_size += ::google::protobuf::internal::WireFormatLite::
+        Int64Size(this->ids(i));
+    }
+    if (data_size > 0) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(data_size);
+    }
+    GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+    _ids_cached_byte_size_ = data_size;
+    GOOGLE_SAFE_CONCURRENT_WRITES_END();
+    total_size += data_size;
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void EdgeBatch::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:mutate.EdgeBatch)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  const EdgeBatch* source = 
+      ::google::protobuf::internal::DynamicCastToGenerated<const EdgeBatch>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:mutate.EdgeBatch)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:mutate.EdgeBatch)
+    MergeFrom(*source);
+  }
+}
+
+void EdgeBatch::MergeFrom(const EdgeBatch& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:mutate.EdgeBatch)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  ids_.MergeFrom(from.ids_);
+  if (from._internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+  }
+}
+
+void EdgeBatch::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:mutate.EdgeBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void EdgeBatch::CopyFrom(const EdgeBatch& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:mutate.EdgeBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool EdgeBatch::IsInitialized() const {
+
+  return true;
+}
+
+void EdgeBatch::Swap(EdgeBatch* other) {
+  if (other == this) return;
+  InternalSwap(other);
+}
+void EdgeBatch::InternalSwap(EdgeBatch* other) {
+  ids_.UnsafeArenaSwap(&other->ids_);
+  std::swap(_has_bits_[0], other->_has_bits_[0]);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  std::swap(_cached_size_, other->_cached_size_);
+}
+
+::google::protobuf::Metadata EdgeBatch::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = EdgeBatch_descriptor_;
+  metadata.reflection = EdgeBatch_reflection_;
+  return metadata;
+}
+
+#if PROTOBUF_INLINE_NOT_IN_HEADERS
+// EdgeBatch
+
+// repeated int64 ids = 1 [packed = true];
+int EdgeBatch::ids_size() const {
+  return ids_.size();
+}
+void EdgeBatch::clear_ids() {
+  ids_.Clear();
+}
+ ::google::protobuf::int64 EdgeBatch::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.EdgeBatch.ids)
+  return ids_.Get(index);
+}
+ void EdgeBatch::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.EdgeBatch.ids)
+}
+ void EdgeBatch::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.EdgeBatch.ids)
+}
+ const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+EdgeBatch::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.EdgeBatch.ids)
+  return ids_;
+}
+ ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+EdgeBatch::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.EdgeBatch.ids)
+  return &ids_;
+}
+
+#endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
+
+// ===================================================================
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int OpBatch::kIdsFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+OpBatch::OpBatch()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:mutate.OpBatch)
+}
+
+void OpBatch::InitAsDefaultInstance() {
+}
+
+OpBatch::OpBatch(const OpBatch& from)
+  : ::google::protobuf::Message(),
+    _internal_metadata_(NULL) {
+  SharedCtor();
+  MergeFrom(from);
+  // @@protoc_insertion_point(copy_constructor:mutate.OpBatch)
+}
+
+void OpBatch::SharedCtor() {
+  _cached_size_ = 0;
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+OpBatch::~OpBatch() {
+  // @@protoc_insertion_point(destructor:mutate.OpBatch)
+  SharedDtor();
+}
+
+void OpBatch::SharedDtor() {
+  if (this != default_instance_) {
+  }
+}
+
+void OpBatch::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* OpBatch::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return OpBatch_descriptor_;
+}
+
+const OpBatch& OpBatch::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_test_2eproto();
+  return *default_instance_;
+}
+
+OpBatch* OpBatch::default_instance_ = NULL;
+
+OpBatch* OpBatch::New(::google::protobuf::Arena* arena) const {
+  OpBatch* n = new OpBatch;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
+void OpBatch::Clear() {
+// @@protoc_insertion_point(message_clear_start:mutate.OpBatch)
+  ids_.Clear();
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  if (_internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->Clear();
+  }
+}
+
+bool OpBatch::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:mutate.OpBatch)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoff(127);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // repeated int64 ids = 1 [packed = true];
+      case 1: {
+        if (tag == 10) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPackedPrimitive<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 input, this->mutable_ids())));
+        } else if (tag == 8) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadRepeatedPrimitiveNoInline<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 1, 10, input, this->mutable_ids())));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectAtEnd()) goto success;
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0 ||
+            ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:mutate.OpBatch)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:mutate.OpBatch)
+  return false;
+#undef DO_
+}
+
+void OpBatch::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:mutate.OpBatch)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteTag(1, ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+    output->WriteVarint32(_ids_cached_byte_size_);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt64NoTag(
+      this->ids(i), output);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+  // @@protoc_insertion_point(serialize_end:mutate.OpBatch)
+}
+
+::google::protobuf::uint8* OpBatch::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  // @@protoc_insertion_point(serialize_to_array_start:mutate.OpBatch)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(
+      1,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      target);
+    target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+      _ids_cached_byte_size_, target);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteInt64NoTagToArray(this->ids(i), target);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:mutate.OpBatch)
+  return target;
+}
+
+int OpBatch::ByteSize() const {
+// @@protoc_insertion_point(message_byte_size_start:mutate.OpBatch)
+  int total_size = 0;
+
+  // repeated int64 ids = 1 [packed = true];
+  {
+    int data_size = 0;
+    for (int i = 0; i < this->ids_size(); i++) {
+      data_size += ::google::protobuf::internal::WireFormatLite::
+        Int64Size(this->ids(i));
+    }
+    if (data_size > 0) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(data_size);
+    }
+    GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+    _ids_cached_byte_size_ = data_size;
+    GOOGLE_SAFE_CONCURRENT_WRITES_END();
+    total_size += data_size;
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void OpBatch::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:mutate.OpBatch)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  const OpBatch* source = 
+      ::google::protobuf::internal::DynamicCastToGenerated<const OpBatch>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:mutate.OpBatch)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:mutate.OpBatch)
+    MergeFrom(*source);
+  }
+}
+
+void OpBatch::MergeFrom(const OpBatch& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:mutate.OpBatch)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  ids_.MergeFrom(from.ids_);
+  if (from._internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+  }
+}
+
+void OpBatch::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:mutate.OpBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void OpBatch::CopyFrom(const OpBatch& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:mutate.OpBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool OpBatch::IsInitialized() const {
+
+  return true;
+}
+
+void OpBatch::Swap(OpBatch* other) {
+  if (other == this) return;
+  InternalSwap(other);
+}
+void OpBatch::InternalSwap(OpBatch* other) {
+  ids_.UnsafeArenaSwap(&other->ids_);
+  std::swap(_has_bits_[0], other->_has_bits_[0]);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  std::swap(_cached_size_, other->_cached_size_);
+}
+
+::google::protobuf::Metadata OpBatch::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = OpBatch_descriptor_;
+  metadata.reflection = OpBatch_reflection_;
+  return metadata;
+}
+
+#if PROTOBUF_INLINE_NOT_IN_HEADERS
+// OpBatch
+
+// repeated int64 ids = 1 [packed = true];
+int OpBatch::ids_size() const {
+  return ids_.size();
+}
+void OpBatch::clear_ids() {
+  ids_.Clear();
+}
+ ::google::protobuf::int64 OpBatch::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.OpBatch.ids)
+  return ids_.Get(index);
+}
+ void OpBatch::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.OpBatch.ids)
+}
+ void OpBatch::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.OpBatch.ids)
+}
+ const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+OpBatch::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.OpBatch.ids)
+  return ids_;
+}
+ ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+OpBatch::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.OpBatch.ids)
+  return &ids_;
+}
+
+#endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
+
+// ===================================================================
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int Filter::kIdsFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+Filter::Filter()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:mutate.Filter)
+}
+
+void Filter::InitAsDefaultInstance() {
+}
+
+Filter::Filter(const Filter& from)
+  : ::google::protobuf::Message(),
+    _internal_metadata_(NULL) {
+  SharedCtor();
+  MergeFrom(from);
+  // @@protoc_insertion_point(copy_constructor:mutate.Filter)
+}
+
+void Filter::SharedCtor() {
+  _cached_size_ = 0;
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+Filter::~Filter() {
+  // @@protoc_insertion_point(destructor:mutate.Filter)
+  SharedDtor();
+}
+
+void Filter::SharedDtor() {
+  if (this != default_instance_) {
+  }
+}
+
+void Filter::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* Filter::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return Filter_descriptor_;
+}
+
+const Filter& Filter::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_test_2eproto();
+  return *default_instance_;
+}
+
+Filter* Filter::default_instance_ = NULL;
+
+Filter* Filter::New(::google::protobuf::Arena* arena) const {
+  Filter* n = new Filter;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
+void Filter::Clear() {
+// @@protoc_insertion_point(message_clear_start:mutate.Filter)
+  ids_.Clear();
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  if (_internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->Clear();
+  }
+}
+
+bool Filter::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:mutate.Filter)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoff(127);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // repeated int64 ids = 1 [packed = true];
+      case 1: {
+        if (tag == 10) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPackedPrimitive<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 input, this->mutable_ids())));
+        } else if (tag == 8) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadRepeatedPrimitiveNoInline<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 1, 10, input, this->mutable_ids())));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectAtEnd()) goto success;
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0 ||
+            ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:mutate.Filter)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:mutate.Filter)
+  return false;
+#undef DO_
+}
+
+void Filter::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:mutate.Filter)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteTag(1, ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+    output->WriteVarint32(_ids_cached_byte_size_);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt64NoTag(
+      this->ids(i), output);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+  // @@protoc_insertion_point(serialize_end:mutate.Filter)
+}
+
+::google::protobuf::uint8* Filter::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  // @@protoc_insertion_point(serialize_to_array_start:mutate.Filter)
+  // repeated int64 ids = 1 [packed = true];
+  if (this->ids_size() > 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(
+      1,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      target);
+    target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+      _ids_cached_byte_size_, target);
+  }
+  for (int i = 0; i < this->ids_size(); i++) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteInt64NoTagToArray(this->ids(i), target);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:mutate.Filter)
+  return target;
+}
+
+int Filter::ByteSize() const {
+// @@protoc_insertion_point(message_byte_size_start:mutate.Filter)
+  int total_size = 0;
+
+  // repeated int64 ids = 1 [packed = true];
+  {
+    int data_size = 0;
+    for (int i = 0; i < this->ids_size(); i++) {
+      data_size += ::google::protobuf::internal::WireFormatLite::
+        Int64Size(this->ids(i));
+    }
+    if (data_size > 0) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(data_size);
+    }
+    GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+    _ids_cached_byte_size_ = data_size;
+    GOOGLE_SAFE_CONCURRENT_WRITES_END();
+    total_size += data_size;
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void Filter::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:mutate.Filter)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  const Filter* source = 
+      ::google::protobuf::internal::DynamicCastToGenerated<const Filter>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:mutate.Filter)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:mutate.Filter)
+    MergeFrom(*source);
+  }
+}
+
+void Filter::MergeFrom(const Filter& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:mutate.Filter)
+  if (GOOGLE_PREDICT_FALSE(&from == this)) {
+    ::google::protobuf::internal::MergeFromFail(__FILE__, __LINE__);
+  }
+  ids_.MergeFrom(from.ids_);
+  if (from._internal_metadata_.have_unknown_fields()) {
+    mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+  }
+}
+
+void Filter::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:mutate.Filter)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void Filter::CopyFrom(const Filter& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:mutate.Filter)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Filter::IsInitialized() const {
+
+  return true;
+}
+
+void Filter::Swap(Filter* other) {
+  if (other == this) return;
+  InternalSwap(other);
+}
+void Filter::InternalSwap(Filter* other) {
+  ids_.UnsafeArenaSwap(&other->ids_);
+  std::swap(_has_bits_[0], other->_has_bits_[0]);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  std::swap(_cached_size_, other->_cached_size_);
+}
+
+::google::protobuf::Metadata Filter::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = Filter_descriptor_;
+  metadata.reflection = Filter_reflection_;
+  return metadata;
+}
+
+#if PROTOBUF_INLINE_NOT_IN_HEADERS
+// Filter
+
+// repeated int64 ids = 1 [packed = true];
+int Filter::ids_size() const {
+  return ids_.size();
+}
+void Filter::clear_ids() {
+  ids_.Clear();
+}
+ ::google::protobuf::int64 Filter::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.Filter.ids)
+  return ids_.Get(index);
+}
+ void Filter::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.Filter.ids)
+}
+ void Filter::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.Filter.ids)
+}
+ const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+Filter::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.Filter.ids)
+  return ids_;
+}
+ ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+Filter::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.Filter.ids)
+  return &ids_;
+}
+
+#endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
+
 // @@protoc_insertion_point(namespace_scope)
 
 }  // namespace mutate
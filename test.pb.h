@@ -38,7 +38,11 @@ void protobuf_ShutdownFile_test_2eproto();
 
 class Code;
 class Edge;
+class EdgeBatch;
+class Filter;
+class Frontier;
 class Node;
+class OpBatch;
 
 // ===================================================================
 
@@ -332,6 +336,394 @@ class Code : public ::google::protobuf::Message /* @@protoc_insertion_point(clas
   void InitAsDefaultInstance();
   static Code* default_instance_;
 };
+// -------------------------------------------------------------------
+
+class Frontier : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:mutate.Frontier) */ {
+ public:
+  Frontier();
+  virtual ~Frontier();
+
+  Frontier(const Frontier& from);
+
+  inline Frontier& operator=(const Frontier& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const Frontier& default_instance();
+
+  void Swap(Frontier* other);
+
+  // implements Message ----------------------------------------------
+
+  inline Frontier* New() const { return New(NULL); }
+
+  Frontier* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const Frontier& from);
+  void MergeFrom(const Frontier& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const {
+    return InternalSerializeWithCachedSizesToArray(false, output);
+  }
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(Frontier* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return _internal_metadata_.arena();
+  }
+  inline void* MaybeArenaPtr() const {
+    return _internal_metadata_.raw_arena_ptr();
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated int64 ids = 1 [packed = true];
+  int ids_size() const;
+  void clear_ids();
+  static const int kIdsFieldNumber = 1;
+  ::google::protobuf::int64 ids(int index) const;
+  void set_ids(int index, ::google::protobuf::int64 value);
+  void add_ids(::google::protobuf::int64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+      ids() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+      mutable_ids();
+
+  // @@protoc_insertion_point(class_scope:mutate.Frontier)
+ private:
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::uint32 _has_bits_[1];
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 > ids_;
+  mutable int _ids_cached_byte_size_;
+  friend void  protobuf_AddDesc_test_2eproto();
+  friend void protobuf_AssignDesc_test_2eproto();
+  friend void protobuf_ShutdownFile_test_2eproto();
+
+  void InitAsDefaultInstance();
+  static Frontier* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class EdgeBatch : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:mutate.EdgeBatch) */ {
+ public:
+  EdgeBatch();
+  virtual ~EdgeBatch();
+
+  EdgeBatch(const EdgeBatch& from);
+
+  inline EdgeBatch& operator=(const EdgeBatch& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const EdgeBatch& default_instance();
+
+  void Swap(EdgeBatch* other);
+
+  // implements Message ----------------------------------------------
+
+  inline EdgeBatch* New() const { return New(NULL); }
+
+  EdgeBatch* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const EdgeBatch& from);
+  void MergeFrom(const EdgeBatch& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const {
+    return InternalSerializeWithCachedSizesToArray(false, output);
+  }
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(EdgeBatch* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return _internal_metadata_.arena();
+  }
+  inline void* MaybeArenaPtr() const {
+    return _internal_metadata_.raw_arena_ptr();
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated int64 ids = 1 [packed = true];
+  int ids_size() const;
+  void clear_ids();
+  static const int kIdsFieldNumber = 1;
+  ::google::protobuf::int64 ids(int index) const;
+  void set_ids(int index, ::google::protobuf::int64 value);
+  void add_ids(::google::protobuf::int64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+      ids() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+      mutable_ids();
+
+  // @@protoc_insertion_point(class_scope:mutate.EdgeBatch)
+ private:
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::uint32 _has_bits_[1];
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 > ids_;
+  mutable int _ids_cached_byte_size_;
+  friend void  protobuf_AddDesc_test_2eproto();
+  friend void protobuf_AssignDesc_test_2eproto();
+  friend void protobuf_ShutdownFile_test_2eproto();
+
+  void InitAsDefaultInstance();
+  static EdgeBatch* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class OpBatch : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:mutate.OpBatch) */ {
+ public:
+  OpBatch();
+  virtual ~OpBatch();
+
+  OpBatch(const OpBatch& from);
+
+  inline OpBatch& operator=(const OpBatch& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const OpBatch& default_instance();
+
+  void Swap(OpBatch* other);
+
+  // implements Message ----------------------------------------------
+
+  inline OpBatch* New() const { return New(NULL); }
+
+  OpBatch* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const OpBatch& from);
+  void MergeFrom(const OpBatch& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const {
+    return InternalSerializeWithCachedSizesToArray(false, output);
+  }
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(OpBatch* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return _internal_metadata_.arena();
+  }
+  inline void* MaybeArenaPtr() const {
+    return _internal_metadata_.raw_arena_ptr();
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated int64 ids = 1 [packed = true];
+  int ids_size() const;
+  void clear_ids();
+  static const int kIdsFieldNumber = 1;
+  ::google::protobuf::int64 ids(int index) const;
+  void set_ids(int index, ::google::protobuf::int64 value);
+  void add_ids(::google::protobuf::int64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+      ids() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+      mutable_ids();
+
+  // @@protoc_insertion_point(class_scope:mutate.OpBatch)
+ private:
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::uint32 _has_bits_[1];
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 > ids_;
+  mutable int _ids_cached_byte_size_;
+  friend void  protobuf_AddDesc_test_2eproto();
+  friend void protobuf_AssignDesc_test_2eproto();
+  friend void protobuf_ShutdownFile_test_2eproto();
+
+  void InitAsDefaultInstance();
+  static OpBatch* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class Filter : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:mutate.Filter) */ {
+ public:
+  Filter();
+  virtual ~Filter();
+
+  Filter(const Filter& from);
+
+  inline Filter& operator=(const Filter& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const Filter& default_instance();
+
+  void Swap(Filter* other);
+
+  // implements Message ----------------------------------------------
+
+  inline Filter* New() const { return New(NULL); }
+
+  Filter* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const Filter& from);
+  void MergeFrom(const Filter& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const {
+    return InternalSerializeWithCachedSizesToArray(false, output);
+  }
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(Filter* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return _internal_metadata_.arena();
+  }
+  inline void* MaybeArenaPtr() const {
+    return _internal_metadata_.raw_arena_ptr();
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated int64 ids = 1 [packed = true];
+  int ids_size() const;
+  void clear_ids();
+  static const int kIdsFieldNumber = 1;
+  ::google::protobuf::int64 ids(int index) const;
+  void set_ids(int index, ::google::protobuf::int64 value);
+  void add_ids(::google::protobuf::int64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+      ids() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+      mutable_ids();
+
+  // @@protoc_insertion_point(class_scope:mutate.Filter)
+ private:
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::uint32 _has_bits_[1];
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 > ids_;
+  mutable int _ids_cached_byte_size_;
+  friend void  protobuf_AddDesc_test_2eproto();
+  friend void protobuf_AssignDesc_test_2eproto();
+  friend void protobuf_ShutdownFile_test_2eproto();
+
+  void InitAsDefaultInstance();
+  static Filter* default_instance_;
+};
 // ===================================================================
 
 
@@ -444,11 +836,155 @@ inline void Code::set_code(::google::protobuf::int32 value) {
   // @@protoc_insertion_point(field_set:mutate.Code.code)
 }
 
+// -------------------------------------------------------------------
+
+// Frontier
+
+// repeated int64 ids = 1 [packed = true];
+inline int Frontier::ids_size() const {
+  return ids_.size();
+}
+inline void Frontier::clear_ids() {
+  ids_.Clear();
+}
+inline ::google::protobuf::int64 Frontier::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.Frontier.ids)
+  return ids_.Get(index);
+}
+inline void Frontier::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.Frontier.ids)
+}
+inline void Frontier::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.Frontier.ids)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+Frontier::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.Frontier.ids)
+  return ids_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+Frontier::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.Frontier.ids)
+  return &ids_;
+}
+
+// -------------------------------------------------------------------
+
+// EdgeBatch
+
+// repeated int64 ids = 1 [packed = true];
+inline int EdgeBatch::ids_size() const {
+  return ids_.size();
+}
+inline void EdgeBatch::clear_ids() {
+  ids_.Clear();
+}
+inline ::google::protobuf::int64 EdgeBatch::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.EdgeBatch.ids)
+  return ids_.Get(index);
+}
+inline void EdgeBatch::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.EdgeBatch.ids)
+}
+inline void EdgeBatch::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.EdgeBatch.ids)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+EdgeBatch::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.EdgeBatch.ids)
+  return ids_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+EdgeBatch::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.EdgeBatch.ids)
+  return &ids_;
+}
+
+// -------------------------------------------------------------------
+
+// OpBatch
+
+// repeated int64 ids = 1 [packed = true];
+inline int OpBatch::ids_size() const {
+  return ids_.size();
+}
+inline void OpBatch::clear_ids() {
+  ids_.Clear();
+}
+inline ::google::protobuf::int64 OpBatch::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.OpBatch.ids)
+  return ids_.Get(index);
+}
+inline void OpBatch::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.OpBatch.ids)
+}
+inline void OpBatch::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.OpBatch.ids)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+OpBatch::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.OpBatch.ids)
+  return ids_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+OpBatch::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.OpBatch.ids)
+  return &ids_;
+}
+
+// -------------------------------------------------------------------
+
+// Filter
+
+// repeated int64 ids = 1 [packed = true];
+inline int Filter::ids_size() const {
+  return ids_.size();
+}
+inline void Filter::clear_ids() {
+  ids_.Clear();
+}
+inline ::google::protobuf::int64 Filter::ids(int index) const {
+  // @@protoc_insertion_point(field_get:mutate.Filter.ids)
+  return ids_.Get(index);
+}
+inline void Filter::set_ids(int index, ::google::protobuf::int64 value) {
+  ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:mutate.Filter.ids)
+}
+inline void Filter::add_ids(::google::protobuf::int64 value) {
+  ids_.Add(value);
+  // @@protoc_insertion_point(field_add:mutate.Filter.ids)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+Filter::ids() const {
+  // @@protoc_insertion_point(field_list:mutate.Filter.ids)
+  return ids_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+Filter::mutable_ids() {
+  // @@protoc_insertion_point(field_mutable_list:mutate.Filter.ids)
+  return &ids_;
+}
+
 #endif  // !PROTOBUF_INLINE_NOT_IN_HEADERS
 // -------------------------------------------------------------------
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
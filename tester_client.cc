@@ -1,5 +1,7 @@
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <grpc++/grpc++.h>
 #include <stdint.h>
@@ -14,10 +16,19 @@ using grpc::Status;
 using mutate::Node;
 using mutate::Edge;
 using mutate::Code;
+using mutate::Frontier;
+using mutate::EdgeBatch;
+using mutate::OpBatch;
+using mutate::Filter;
 using mutate::Mutator;
 
 extern int CHAIN_NUM;
-extern char* NEXT_IP;
+extern __thread char* NEXT_IP;
+
+// Gives context a deadline ms from now
+static void set_deadline(ClientContext *context, int ms) {
+  context->set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(ms));
+}
 
 
 
@@ -33,6 +44,7 @@ public:
     Code code;
 
     ClientContext context;
+    set_deadline(&context, RPC_DEADLINE_MS);
     // The actual RPC.
     Status status = stub_->add_node(&context, toAdd, &code);
 
@@ -54,6 +66,7 @@ public:
     Code code;
 
     ClientContext context;
+    set_deadline(&context, RPC_DEADLINE_MS);
     // The actual RPC.
     Status status = stub_->add_edge_alt(&context, toAdd, &code);
 
@@ -74,6 +87,7 @@ public:
     Code code;
 
     ClientContext context;
+    set_deadline(&context, RPC_DEADLINE_MS);
     // The actual RPC.
     Status status = stub_->remove_edge_alt(&context, toRem, &code);
 
@@ -93,6 +107,7 @@ public:
     Code code;
 
     ClientContext context;
+    set_deadline(&context, RPC_DEADLINE_MS);
     // The actual RPC.
     Status status = stub_->get_node_alt(&context, toGet, &code);
     // if code == 200, it is in the graph. if it is 400, it is not in the graph.
@@ -105,6 +120,127 @@ public:
       return 500;
     }
   }
+  // Fills *out with the neighbors of the given vertices, adding the
+  // bytes shipped both ways to *bytes; returns false if the RPC failed
+  bool expand_frontier(const uint64_t *ids, size_t count, uint64_t **out,
+    size_t *n, uint64_t *bytes) {
+    Frontier request;
+    request.mutable_ids()->Reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      request.add_ids(ids[i]);
+    }
+
+    Frontier reply;
+
+    ClientContext context;
+    set_deadline(&context, RPC_BATCH_DEADLINE_MS);
+    // The actual RPC.
+    Status status = stub_->expand_frontier(&context, request, &reply);
+
+    if (!status.ok()) {
+      std::cout <<  "RPC failed" << std::endl;
+      return false;
+    }
+    *bytes += request.ByteSize() + reply.ByteSize();
+    *n = reply.ids_size();
+    *out = (uint64_t *) malloc(sizeof(uint64_t) * (*n ? *n : 1));
+    if (*n) {
+      memcpy(*out, reply.ids().data(), sizeof(uint64_t) * *n);
+    }
+    return true;
+  }
+  // Sends count edges (2 * count ids) to be added; returns false if the
+  // RPC failed
+  bool add_edges(const uint64_t *pairs, size_t count) {
+    EdgeBatch request;
+    request.mutable_ids()->Reserve(2 * count);
+    for (size_t i = 0; i < 2 * count; i++) {
+      request.add_ids(pairs[i]);
+    }
+
+    Code code;
+
+    ClientContext context;
+    set_deadline(&context, RPC_BATCH_DEADLINE_MS);
+    // The actual RPC.
+    Status status = stub_->add_edges(&context, request, &code);
+
+    if (!status.ok()) {
+      std::cout <<  "RPC failed" << std::endl;
+      return false;
+    }
+    return code.code() == 200;
+  }
+  // Sends count (op, a, b) triples to be applied in order, and fills
+  // codes with one code per triple; returns false if the RPC failed
+  bool apply_ops(const uint64_t *ops, size_t count, uint64_t *codes) {
+    OpBatch request;
+    request.mutable_ids()->Reserve(3 * count);
+    for (size_t i = 0; i < 3 * count; i++) {
+      request.add_ids(ops[i]);
+    }
+
+    OpBatch reply;
+
+    ClientContext context;
+    set_deadline(&context, RPC_BATCH_DEADLINE_MS);
+    // The actual RPC.
+    Status status = stub_->apply_ops(&context, request, &reply);
+
+    if (!status.ok() || (size_t) reply.ids_size() != count) {
+      std::cout <<  "RPC failed" << std::endl;
+      return false;
+    }
+    memcpy(codes, reply.ids().data(), sizeof(uint64_t) * count);
+    return true;
+  }
+  // Sends count sorted ids and sets *sum to the partition's sum of the
+  // common neighbors of its own among them with them; returns false if
+  // the RPC failed
+  bool count_common(const uint64_t *ids, size_t count, uint64_t *sum) {
+    Frontier request;
+    request.mutable_ids()->Reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      request.add_ids(ids[i]);
+    }
+
+    Frontier reply;
+
+    ClientContext context;
+    set_deadline(&context, RPC_BATCH_DEADLINE_MS);
+    // The actual RPC.
+    Status status = stub_->count_common(&context, request, &reply);
+
+    if (!status.ok() || reply.ids_size() != 1) {
+      std::cout <<  "RPC failed" << std::endl;
+      return false;
+    }
+    *sum = reply.ids(0);
+    return true;
+  }
+  // Sends n words of a filter to replace the one held for this
+  // partition; returns PUSH_TAKEN, PUSH_UNSENT or PUSH_UNKNOWN
+  int push_filter(const uint64_t *words, size_t n) {
+    Filter request;
+    request.mutable_ids()->Resize(n, 0);
+    memcpy(request.mutable_ids()->mutable_data(), words, sizeof(uint64_t) * n);
+
+    Code code;
+
+    ClientContext context;
+    set_deadline(&context, FILTER_RPC_MS);
+    // The actual RPC.
+    Status status = stub_->push_filter(&context, request, &code);
+
+    if (!status.ok()) {
+      std::cout <<  "RPC failed" << std::endl;
+      // no connection to the peer: the push never left
+      if (status.error_code() == grpc::StatusCode::UNAVAILABLE) return PUSH_UNSENT;
+      // past the deadline, among others, the peer may still take it
+      return PUSH_UNKNOWN;
+    }
+    return code.code() == 200 ? PUSH_TAKEN : PUSH_UNKNOWN;
+  }
 private:
   std::unique_ptr<Mutator::Stub> stub_;
 
@@ -137,3 +273,44 @@ int send_to_next(const uint64_t opcode, const uint64_t id_a, const uint64_t id_b
     std::cout << "Client received status code: " << code << std::endl;
     return code;
   }
+
+// Channels to the other partitions, opened on first use and kept, since
+// searches, bulk loads and batches send to them over and over
+static std::shared_ptr<Channel> channels[PARTITIONS + 1];
+static std::mutex channels_lock;
+
+// Returns the channel to partition
+static std::shared_ptr<Channel> partition_channel(int partition) {
+  std::lock_guard<std::mutex> guard(channels_lock);
+  if (!channels[partition]) {
+    channels[partition] = grpc::CreateChannel(partition_ip(partition),
+      grpc::InsecureChannelCredentials());
+  }
+  return channels[partition];
+}
+
+bool send_frontier(int partition, const uint64_t *ids, size_t count,
+  uint64_t **out, size_t *n, uint64_t *bytes) {
+  MutatorClient mutator(partition_channel(partition));
+  return mutator.expand_frontier(ids, count, out, n, bytes);
+}
+
+bool send_edges(int partition, const uint64_t *pairs, size_t count) {
+  MutatorClient mutator(partition_channel(partition));
+  return mutator.add_edges(pairs, count);
+}
+
+bool send_ops(int partition, const uint64_t *ops, size_t count, uint64_t *codes) {
+  MutatorClient mutator(partition_channel(partition));
+  return mutator.apply_ops(ops, count, codes);
+}
+
+bool send_common(int partition, const uint64_t *ids, size_t count, uint64_t *sum) {
+  MutatorClient mutator(partition_channel(partition));
+  return mutator.count_common(ids, count, sum);
+}
+
+int send_filter(int partition, const uint64_t *words, size_t n) {
+  MutatorClient mutator(partition_channel(partition));
+  return mutator.push_filter(words, n);
+}
@@ -15,12 +15,15 @@ using grpc::Status;
 using mutate::Node;
 using mutate::Edge;
 using mutate::Code;
+using mutate::Frontier;
+using mutate::EdgeBatch;
+using mutate::OpBatch;
+using mutate::Filter;
 using mutate::Mutator;
 
 extern int CHAIN_NUM;
-extern char* NEXT_IP;
+extern __thread char* NEXT_IP;
 extern char* RPC_PORT;
-extern pthread_mutex_t mt;
 
 
 // define the service class.
@@ -29,7 +32,7 @@ class TesterService final : public Mutator::Service {
   Status add_node(ServerContext* context, const Node* node,
     Code* reply) override {
 
-	pthread_mutex_lock(&mt);
+	lock_node(node->id(), true);
 
       bool result;
       int r_code;
@@ -42,20 +45,22 @@ class TesterService final : public Mutator::Service {
         reply->set_code(204);
       }
 
-	pthread_mutex_unlock(&mt); 
+	unlock_node(node->id()); 
+      filter_sync();
       return Status::OK; 
     }
   
       Status add_edge_alt(ServerContext* context, const Edge* edge,
         Code* reply) override {
 
-	pthread_mutex_lock(&mt);
+	lock_edge(edge->id_a(), edge->id_b(), true);
 
           printf("Received: Add edge %d - %d\n", (int) edge->id_a(), (int) edge->id_b());
           int result;
           int r_code;   
-          // Apply change and reply
-          result = add_edge(edge->id_a(), edge->id_b());
+          // Apply change and reply; the sender's node is kept here as
+          // a ghost only if the edge is added
+          result = add_cross_edge(edge->id_a(), edge->id_b());
           if (result==200) {
             printf("Added edge %d, %d\n", (int) edge->id_a(), (int) edge->id_b());
             reply->set_code(200);
@@ -63,7 +68,7 @@ class TesterService final : public Mutator::Service {
             reply->set_code(result);
           }
 
-	pthread_mutex_unlock(&mt);
+	unlock_edge(edge->id_a(), edge->id_b());
 
           return Status::OK;
         }
@@ -71,7 +76,7 @@ class TesterService final : public Mutator::Service {
         Status remove_edge_alt(ServerContext* context, const Edge* edge,
           Code* reply) override {
 
-	pthread_mutex_lock(&mt);
+	lock_edge(edge->id_a(), edge->id_b(), true);
 
             printf("Received: Remove edge %d - %d\n", (int) edge->id_a(), (int) edge->id_b());
             bool result;
@@ -92,7 +97,7 @@ class TesterService final : public Mutator::Service {
               reply->set_code(400);
             }
 
-	pthread_mutex_unlock(&mt);
+	unlock_edge(edge->id_a(), edge->id_b());
 
             return Status::OK;
             
@@ -101,8 +106,6 @@ class TesterService final : public Mutator::Service {
         Status get_node_alt(ServerContext* context, const Node* node,
           Code* reply) override {
 
-	pthread_mutex_lock(&mt);
-
             bool result;
             int r_code;
        
@@ -114,7 +117,60 @@ class TesterService final : public Mutator::Service {
               reply->set_code(400);
             }
 
-	pthread_mutex_unlock(&mt);
+            return Status::OK;
+          }
+
+        Status expand_frontier(ServerContext* context, const Frontier* frontier,
+          Frontier* reply) override {
+
+            size_t n;
+            uint64_t *neighbors = frontier_neighbors(
+              (const uint64_t *) frontier->ids().data(), frontier->ids_size(), &n);
+
+            reply->mutable_ids()->Reserve(n);
+            for (size_t i = 0; i < n; i++) {
+              reply->add_ids(neighbors[i]);
+            }
+            free(neighbors);
+
+            return Status::OK;
+          }
+
+        Status add_edges(ServerContext* context, const EdgeBatch* batch,
+          Code* reply) override {
+
+            // a code other than 200 fails the sender's load
+            reply->set_code(receive_edges((const uint64_t *) batch->ids().data(),
+              batch->ids_size()));
+
+            return Status::OK;
+          }
+
+        Status apply_ops(ServerContext* context, const OpBatch* batch,
+          OpBatch* reply) override {
+
+            size_t n = batch->ids_size() / 3;
+            reply->mutable_ids()->Resize(n, 0);
+            ::apply_ops((const uint64_t *) batch->ids().data(), n,
+              (uint64_t *) reply->mutable_ids()->mutable_data());
+
+            return Status::OK;
+          }
+
+        Status count_common(ServerContext* context, const Frontier* frontier,
+          Frontier* reply) override {
+
+            reply->add_ids(::count_common(
+              (const uint64_t *) frontier->ids().data(), frontier->ids_size()));
+
+            return Status::OK;
+          }
+
+        Status push_filter(ServerContext* context, const Filter* filter,
+          Code* reply) override {
+
+            filter_receive((const uint64_t *) filter->ids().data(), filter->ids_size());
+            reply->set_code(200);
 
             return Status::OK;
           }